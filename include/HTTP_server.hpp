@@ -43,6 +43,18 @@
  *                      Macros
  ******************************************************/
 
+#if ( __cplusplus >= 201402L )
+/**
+ * Defines a \ref HTTPRouteTable named name over a constexpr array of \ref cy_http_resource_t, and checks at compile
+ * time that no two of its resources have the same URL and MIME type or match the same request URLs with different
+ * wildcards.
+ */
+#define HTTP_SERVER_ROUTE_TABLE( name, resources ) \
+    constexpr HTTPRouteTable< sizeof( resources ) / sizeof( ( resources )[ 0 ] ) > name( resources ); \
+    static_assert( !name.has_duplicate_urls(), "Two resources of " #resources " have the same URL and MIME type" ); \
+    static_assert( !name.has_conflicting_wildcards(), "Two resources of " #resources " match the same request URLs" )
+#endif
+
 /******************************************************
  *                    Constants
  ******************************************************/
@@ -81,6 +93,177 @@
  * @{
  */
 /*****************************************************************************/
+#if ( __cplusplus >= 201402L )
+/**
+ * Fixed set of resources declared at compile time, registered by \ref HTTPServer::register_resources in a single
+ * update of the resource database. Define it with \ref HTTP_SERVER_ROUTE_TABLE, e.g.
+ *
+ *     static cy_resource_dynamic_data_t status = { status_handler, NULL, NULL };
+ *     constexpr cy_http_resource_t resources[] =
+ *     {
+ *         { "/status",    "application/json", CY_DYNAMIC_URL_CONTENT, &status, CY_HTTP_METHOD_BIT( CY_HTTP_REQUEST_GET ) },
+ *         { "/led/{id:u32}", "text/plain",    CY_DYNAMIC_URL_CONTENT, &led,    CY_HTTP_METHOD_BIT( CY_HTTP_REQUEST_PUT ) },
+ *     };
+ *     HTTP_SERVER_ROUTE_TABLE( routes, resources );
+ *
+ * Route templates are matched by the resource database as for \ref cy_http_server_register_resource; the checks here
+ * only find routes that would shadow one another.
+ */
+template< size_t N >
+class HTTPRouteTable
+{
+    static_assert( ( N > 0 ) && ( N <= 0xFFFF ), "A route table has 1 to 65535 resources" );
+
+public:
+    /**
+     * Route table over a constexpr array of resources, which must outlive it
+     *
+     * @param[in] resources          : Resources of the table, in order of registration
+     */
+    constexpr explicit HTTPRouteTable( const cy_http_resource_t ( &resources )[ N ] ) : table( resources ) {}
+
+    /** Resources of the table */
+    constexpr const cy_http_resource_t* resources() const { return table; }
+
+    /** Number of resources of the table */
+    constexpr uint16_t count() const { return (uint16_t) N; }
+
+    /**
+     * Returns true if two resources of the table have the same URL and MIME type. Resources with the same URL and
+     * different MIME types are all registered, and a request is served by the one of the MIME type it asks for.
+     */
+    constexpr bool has_duplicate_urls() const
+    {
+        for( size_t i = 0; i < N; i++ )
+        {
+            for( size_t j = i + 1; j < N; j++ )
+            {
+                if( same_url( table[ i ].url, table[ j ].url ) && same_mime_type( table[ i ].mime_type, table[ j ].mime_type ) )
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Returns true if two resources of the table have different URLs matching the same request URLs, such as
+     * "/led/{id}" and "/led/ *", so that only the one registered first is ever found
+     */
+    constexpr bool has_conflicting_wildcards() const
+    {
+        for( size_t i = 0; i < N; i++ )
+        {
+            for( size_t j = i + 1; j < N; j++ )
+            {
+                if( !same_url( table[ i ].url, table[ j ].url ) && same_segments( table[ i ].url, table[ j ].url ) )
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+private:
+    /* What a path segment of a URL matches */
+    enum segment_kind { SEGMENT_LITERAL, SEGMENT_ANY, SEGMENT_U32, SEGMENT_HEX };
+
+    static constexpr bool same_url( const char* a, const char* b )
+    {
+        while( ( *a != '\0' ) && ( *a == *b ) )
+        {
+            a++;
+            b++;
+        }
+        return *a == *b;
+    }
+
+    static constexpr bool same_mime_type( const char* a, const char* b )
+    {
+        return ( ( a == nullptr ) || ( b == nullptr ) ) ? ( a == b ) : same_url( a, b );
+    }
+
+    static constexpr bool same_text( const char* a, const char* b, size_t length )
+    {
+        for( size_t i = 0; i < length; i++ )
+        {
+            if( a[ i ] != b[ i ] )
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static constexpr size_t segment_length( const char* segment )
+    {
+        size_t length = 0;
+
+        while( ( segment[ length ] != '\0' ) && ( segment[ length ] != '/' ) )
+        {
+            length++;
+        }
+        return length;
+    }
+
+    /* A '*' matches one segment only if followed by '/'; at the end of a URL it matches any rest, as a literal prefix */
+    static constexpr segment_kind kind_of( const char* segment, size_t length )
+    {
+        size_t name = 1;
+
+        if( ( length == 1 ) && ( segment[ 0 ] == '*' ) && ( segment[ 1 ] == '/' ) )
+        {
+            return SEGMENT_ANY;
+        }
+        if( ( length < 3 ) || ( segment[ 0 ] != '{' ) || ( segment[ length - 1 ] != '}' ) )
+        {
+            return SEGMENT_LITERAL;
+        }
+        while( ( name < length - 1 ) && ( segment[ name ] != ':' ) )
+        {
+            name++;
+        }
+        if( ( length - name == 5 ) && same_text( segment + name, ":u32}", 5 ) )
+        {
+            return SEGMENT_U32;
+        }
+        if( ( length - name == 5 ) && same_text( segment + name, ":hex}", 5 ) )
+        {
+            return SEGMENT_HEX;
+        }
+        return SEGMENT_ANY;
+    }
+
+    /* Whether two URLs have the same literal segments and the same kinds of parameter segments, in the same places */
+    static constexpr bool same_segments( const char* a, const char* b )
+    {
+        for( ;; )
+        {
+            size_t       length_a = segment_length( a );
+            size_t       length_b = segment_length( b );
+            segment_kind kind_a   = kind_of( a, length_a );
+            segment_kind kind_b   = kind_of( b, length_b );
+
+            if( ( kind_a != kind_b ) ||
+                ( ( kind_a == SEGMENT_LITERAL ) && ( ( length_a != length_b ) || !same_text( a, b, length_a ) ) ) )
+            {
+                return false;
+            }
+            if( ( a[ length_a ] == '\0' ) || ( b[ length_b ] == '\0' ) )
+            {
+                return a[ length_a ] == b[ length_b ];
+            }
+            a += length_a + 1;
+            b += length_b + 1;
+        }
+    }
+
+    const cy_http_resource_t* table;
+};
+#endif
+
 /** Definition of the HTTP server class object */
 class HTTPServer
 {
@@ -138,6 +321,21 @@ public:
     **/
     cy_rslt_t register_resource( uint8_t* url, uint8_t* mime_type, cy_url_resource_type url_resource_type, void* resource_data );
 
+#if ( __cplusplus >= 201402L )
+    /**
+     * Used to register the resources of a route table with the HTTP server, in a single update of the resource database.
+     *
+     * @param[in] routes              :   Route table defined with \ref HTTP_SERVER_ROUTE_TABLE.
+     *
+     * @return cy_rslt_t              : CY_RSLT_SUCCESS - on success, error codes in \ref http_server_defines otherwise.
+    **/
+    template< size_t N >
+    cy_rslt_t register_resources( const HTTPRouteTable< N >& routes )
+    {
+        return cy_http_server_register_resources( http_server_obj, routes.resources(), routes.count() );
+    }
+#endif
+
     /**
      * Enable chunked transfer encoding on the HTTP stream
      *
@@ -146,19 +146,167 @@ extern "C" {
 #define CY_RSLT_ERROR                                   ((cy_rslt_t)(CY_RSLT_HTTP_SERVER_ERR_BASE + 11))
 
 /**
- * Max number of resources supported by the HTTP server.
+ * Max number of resources of a server created with \ref cy_http_server_create_static. A server created with
+ * \ref cy_http_server_create has room for this many resources at first, and takes more memory as more are registered.
  * \note Change this macro to support more resources.
  */
 #ifndef MAX_NUMBER_OF_HTTP_SERVER_RESOURCES
 #define MAX_NUMBER_OF_HTTP_SERVER_RESOURCES            (10)
 #endif
 
+/**
+ * Default max number of bytes read from a connection at a time; see \ref cy_http_server_set_receive_size.
+ */
+#ifndef HTTP_SERVER_MTU_SIZE
+#define HTTP_SERVER_MTU_SIZE                           (1460)
+#endif
+
 /**
  * Socket receive timeout in milliseconds 
  */
 #ifndef HTTP_SERVER_SOCKET_RECEIVE_TIMEOUT
 #define HTTP_SERVER_SOCKET_RECEIVE_TIMEOUT             (10)
 #endif
+
+/**
+ * Max number of request headers indexed per request for \ref cy_http_server_get_request_header.
+ * \note Headers beyond this count are still parsed but cannot be looked up.
+ */
+#ifndef HTTP_SERVER_MAX_REQUEST_HEADERS
+#define HTTP_SERVER_MAX_REQUEST_HEADERS                (16)
+#endif
+
+/**
+ * Max number of URL query parameters indexed per request for \ref cy_http_server_get_query_parameter_by_key and \ref cy_http_server_get_query_parameter_by_position.
+ * \note Parameters beyond this count are still counted but can only be found with \ref cy_http_server_get_query_parameter_value.
+ */
+#ifndef HTTP_SERVER_MAX_QUERY_PARAMETERS
+#define HTTP_SERVER_MAX_QUERY_PARAMETERS               (16)
+#endif
+
+/**
+ * Max number of path parameters captured per request from the '{name}' and '*' segments of a route template; see
+ * \ref cy_http_server_register_resource and \ref cy_http_server_get_path_parameters.
+ */
+#ifndef HTTP_SERVER_MAX_PATH_PARAMETERS
+#define HTTP_SERVER_MAX_PATH_PARAMETERS                (4)
+#endif
+
+/**
+ * Max length of a field name decoded by the form decoder (\ref cy_http_form_decoder_t).
+ */
+#ifndef HTTP_SERVER_FORM_MAX_KEY_LENGTH
+#define HTTP_SERVER_FORM_MAX_KEY_LENGTH                (64)
+#endif
+
+/**
+ * Size of the buffer in which the form decoder (\ref cy_http_form_decoder_t) collects decoded value bytes before passing them to the application.
+ */
+#ifndef HTTP_SERVER_FORM_VALUE_BUFFER_SIZE
+#define HTTP_SERVER_FORM_VALUE_BUFFER_SIZE             (64)
+#endif
+
+/**
+ * Max length of a multipart boundary. RFC 2046 limits boundaries to 70 characters.
+ */
+#ifndef HTTP_SERVER_MULTIPART_MAX_BOUNDARY_LENGTH
+#define HTTP_SERVER_MULTIPART_MAX_BOUNDARY_LENGTH      (70)
+#endif
+
+/**
+ * Max length of a part header line accepted by the multipart parser (\ref cy_http_multipart_parser_t).
+ */
+#ifndef HTTP_SERVER_MULTIPART_MAX_HEADER_LENGTH
+#define HTTP_SERVER_MULTIPART_MAX_HEADER_LENGTH        (256)
+#endif
+
+/**
+ * Max length of a request header that arrives split across several packets. Longer requests are dropped and their
+ * connection closed.
+ */
+#ifndef HTTP_SERVER_REASSEMBLY_BUFFER_SIZE
+#define HTTP_SERVER_REASSEMBLY_BUFFER_SIZE             (8192)
+#endif
+
+/**
+ * Number of buffers, each of \ref HTTP_SERVER_REASSEMBLY_BUFFER_SIZE bytes, allocated when the server starts for
+ * reassembling split request headers. With the default of 0 there is one per connection, so every connection can
+ * always reassemble its header. A smaller number shares the buffers between connections to save memory: a connection
+ * holds one only while its request header is incomplete, and one finding none free is answered
+ * "503 Service Unavailable" and closed. Packets are received straight into a free buffer, so one more than the number
+ * of headers expected to be incomplete at once avoids copying received data.
+ */
+#ifndef HTTP_SERVER_REASSEMBLY_BUFFER_COUNT
+#define HTTP_SERVER_REASSEMBLY_BUFFER_COUNT            (0)
+#endif
+
+/**
+ * Default max number of bytes of an incomplete request header one connection may hold in a reassembly buffer. A
+ * connection reaching it before the end of its header is answered "431 Request Header Fields Too Large" and closed.
+ * At most \ref HTTP_SERVER_REASSEMBLY_BUFFER_SIZE; see \ref cy_http_server_set_memory_budget.
+ */
+#ifndef HTTP_SERVER_CONNECTION_MEMORY_BUDGET
+#define HTTP_SERVER_CONNECTION_MEMORY_BUDGET           HTTP_SERVER_REASSEMBLY_BUFFER_SIZE
+#endif
+
+/**
+ * Default max number of bytes of incomplete request headers all connections together may hold. A connection that would
+ * take the total over it, or finds no reassembly buffer free, is answered "503 Service Unavailable" and closed. 0 sets
+ * no limit apart from the number of reassembly buffers; see \ref cy_http_server_set_memory_budget.
+ */
+#ifndef HTTP_SERVER_TOTAL_MEMORY_BUDGET
+#define HTTP_SERVER_TOTAL_MEMORY_BUDGET                (0)
+#endif
+
+/**
+ * Stack size of the thread accepting connections
+ */
+#ifndef HTTP_SERVER_CONNECT_THREAD_STACK_SIZE
+#if defined(__llvm__)
+#define HTTP_SERVER_CONNECT_THREAD_STACK_SIZE          (8 * 1024)
+#else
+#define HTTP_SERVER_CONNECT_THREAD_STACK_SIZE          (7 * 1024)
+#endif
+#endif
+
+/**
+ * Stack size of the thread processing requests
+ */
+#ifndef HTTP_SERVER_EVENT_THREAD_STACK_SIZE
+#if defined(__llvm__)
+#define HTTP_SERVER_EVENT_THREAD_STACK_SIZE            (10 * 1024)
+#else
+#define HTTP_SERVER_EVENT_THREAD_STACK_SIZE            (8 * 1024)
+#endif
+#endif
+
+/**
+ * Memory taken by the server object of a server created with \ref cy_http_server_create_static, apart from its resource
+ * database. Used by \ref CY_HTTP_SERVER_STATIC_MEMORY_SIZE.
+ * \note The library fails to build if this is too small for the target.
+ */
+#ifndef HTTP_SERVER_STATIC_SERVER_OVERHEAD
+#define HTTP_SERVER_STATIC_SERVER_OVERHEAD             (1024)
+#endif
+
+/**
+ * Memory taken per resource in the resource database of a server created with \ref cy_http_server_create_static,
+ * which is kept twice so that resources can be registered and unregistered while the server runs.
+ * Used by \ref CY_HTTP_SERVER_STATIC_MEMORY_SIZE.
+ * \note The library fails to build if this is too small for the target.
+ */
+#ifndef HTTP_SERVER_STATIC_RESOURCE_OVERHEAD
+#define HTTP_SERVER_STATIC_RESOURCE_OVERHEAD           (320)
+#endif
+
+/**
+ * Memory taken per connection by a server created with \ref cy_http_server_create_static, apart from the reassembly
+ * buffers. Used by \ref CY_HTTP_SERVER_STATIC_MEMORY_SIZE.
+ * \note The library fails to build if this is too small for the target.
+ */
+#ifndef HTTP_SERVER_STATIC_CONNECTION_OVERHEAD
+#define HTTP_SERVER_STATIC_CONNECTION_OVERHEAD         (1280)
+#endif
 /**
  * @}
  */
@@ -176,7 +324,7 @@ extern "C" {
 /** Macro to expand the enumeration */
 #define EXPAND_AS_ENUMERATION(a,b)   a,
 
-/** MIME table */
+/** MIME table. Entries starting with the same character are kept next to each other. */
 #define MIME_TABLE( ENTRY ) \
     ENTRY( MIME_TYPE_TLV = 0 ,                "application/x-tlv8"               ) \
     ENTRY( MIME_TYPE_APPLE_BINARY_PLIST,      "application/x-apple-binary-plist" ) \
@@ -207,9 +355,18 @@ typedef enum
     CY_HTTP_REQUEST_GET,       /**< HTTP server GET request type */
     CY_HTTP_REQUEST_POST,      /**< HTTP server POST request type */
     CY_HTTP_REQUEST_PUT,       /**< HTTP server PUT request type*/
+    CY_HTTP_REQUEST_HEAD,      /**< HTTP server HEAD request type. Static resources are answered by the server. The server sends the response header alone for a CY_DYNAMIC_URL_CONTENT resource, dropping the payload its URL processor writes. A CY_RAW_DYNAMIC_URL_CONTENT resource only takes HEAD once set with \ref cy_http_server_set_resource_methods, and its URL processor must then write the response header only */
+    CY_HTTP_REQUEST_DELETE,    /**< HTTP server DELETE request type. Only taken by resources it is set for with \ref cy_http_server_set_resource_methods */
+    CY_HTTP_REQUEST_PATCH,     /**< HTTP server PATCH request type. Only taken by resources it is set for with \ref cy_http_server_set_resource_methods */
+    CY_HTTP_REQUEST_OPTIONS,   /**< HTTP server OPTIONS request type. Answered by the server; URL processors are not called */
     CY_HTTP_REQUEST_UNDEFINED  /**< HTTP server undefined request type */
 } cy_http_request_type_t;
 
+/**
+ * Bit of a request type in the method set passed to \ref cy_http_server_set_resource_methods
+ */
+#define CY_HTTP_METHOD_BIT( type )    ( (uint8_t)( 1U << (type) ) )
+
 /**
  * HTTP cache
  */
@@ -255,7 +412,14 @@ typedef enum
     CY_HTTP_444_TYPE, /**< No Response */
     CY_HTTP_470_TYPE, /**< Connection Authorization Required */
     CY_HTTP_500_TYPE, /**< Internal Server Error */
-    CY_HTTP_504_TYPE  /**< Gateway Timeout */
+    CY_HTTP_504_TYPE, /**< Gateway Timeout */
+
+    /* Added after the codes above so that their values do not change; all are errors, so they follow CY_HTTP_400_TYPE */
+    CY_HTTP_413_TYPE = 16, /**< Payload Too Large */
+    CY_HTTP_417_TYPE = 17, /**< Expectation Failed */
+    CY_HTTP_431_TYPE = 18, /**< Request Header Fields Too Large */
+    CY_HTTP_501_TYPE = 19, /**< Not Implemented */
+    CY_HTTP_503_TYPE = 20  /**< Service Unavailable */
 } cy_http_status_codes_t;
 
 /**
@@ -285,12 +449,13 @@ typedef void* cy_http_server_t;
  */
 typedef struct
 {
-    const uint8_t             *data;                        /**< Packet data in message body      */
-    uint16_t                  data_length;                  /**< Data length in current packet    */
-    uint32_t                  data_remaining;               /**< Data yet to be consumed          */
-    bool                      is_chunked_transfer;          /**< Chunked data format              */
+    const uint8_t             *data;                        /**< Packet data in message body. Points into the receive buffer, which is not copied and is valid only until the URL handler returns */
+    uint32_t                  data_length;                  /**< Data length in current packet    */
+    uint32_t                  data_remaining;               /**< Data yet to be consumed. For a chunked request body, the data yet to be received of the current chunk */
+    bool                      is_chunked_transfer;          /**< Request body was sent with chunked transfer coding. The chunk framing has been removed from data */
     cy_http_mime_type_t       mime_type;                    /**< MIME type                        */
     cy_http_request_type_t    request_type;                 /**< Request type                     */
+    bool                      end_of_body;                  /**< This is the last part of the request body */
 } cy_http_message_body_t;
 
 /**
@@ -302,18 +467,29 @@ typedef struct
 {
     cy_tcp_stream_t tcp_stream;                /**< TCP stream handle */
     bool            chunked_transfer_enabled;  /**< Flag to indicate whether chunked transfer is enabled */
+    bool            omit_payload;              /**< Payload and chunk framing are not sent; set for a HEAD request to a CY_DYNAMIC_URL_CONTENT resource */
     cy_mutex_t      mutex;                     /**< Mutex for critical section */
 } cy_http_response_stream_t;
 
 /**
  * Prototype for URL processor functions
  *
+ * A request body larger than one packet is delivered in parts: the function is called once with the request, and then
+ * again for each further packet of the body with url_query_string set to NULL. Lengths are 32-bit, so a body may be
+ * of any size up to 4 GB. \ref cy_http_server_request_body_pause stops further parts until \ref cy_http_server_request_body_resume
+ * is called, for a URL processor that consumes the body more slowly than it arrives.
+ *
+ * \note The URL, query string, headers and body data all point into the buffer the request was received in. It is reused
+ *       for the next packet, so data needed after the function returns must be copied.
+ *
  * @param[in] url_path           : URL path.
- * @param[in] url_query_string   : NULL terminated URL query string.
+ * @param[in] url_query_string   : NULL terminated URL query string; NULL for the further parts of a request body.
  * @param[in] stream             : HTTP stream on which data was received.
  * @param[in] arg                : Arguments passed along with callback function.
  * @param[in] http_data          : Buffer having HTTP data
  *
+ * @return int32_t               : 0 to continue. A non-zero value while \ref cy_http_message_body_t::end_of_body is false
+ *                                 drops the rest of the request body and closes the connection.
  */
 typedef int32_t (*url_processor_t)( const char *url_path, const char *url_query_string, cy_http_response_stream_t *stream, void *arg, cy_http_message_body_t *http_data );
 
@@ -328,11 +504,55 @@ typedef struct
     uint16_t    root_ca_certificate_length; /**< Root CA certificate length excluding 'null' termination character */
 } cy_https_server_security_info_t;
 
+/**
+ * Path segment of the request URL matched by a '{name}' or '*' segment of a route template
+ */
+typedef struct
+{
+    const char  *value;                     /**< Segment in the request URL; not NULL-terminated */
+    const char  *name;                      /**< Name in the route template; not NULL-terminated. Empty for a '*' segment */
+    uint32_t    value_length;               /**< Length of the segment */
+    uint32_t    number;                     /**< Value of a '{name:u32}' or '{name:hex}' segment; 0 for other segments */
+    uint16_t    name_length;                /**< Length of the name */
+} cy_http_path_parameter_t;
+
+/**
+ * Memory held by the connections of a HTTP server for incomplete request headers, counted since the server was
+ * started; see \ref cy_http_server_get_memory_usage. The peaks help size max_connection and the reassembly buffers.
+ */
+typedef struct
+{
+    uint32_t    header_bytes;               /**< Bytes held by all connections now */
+    uint32_t    header_bytes_peak;          /**< Most bytes held by all connections at once */
+    uint32_t    connection_peak;            /**< Most bytes held by a single connection */
+    uint32_t    connection_rejections;      /**< Requests answered 431 for exceeding the per-connection budget */
+    uint32_t    total_rejections;           /**< Requests answered 503 for exceeding the total budget or finding no reassembly buffer */
+} cy_http_server_memory_usage_t;
+
+/**
+ * Prototype for functions deciding on a request that carries "Expect: 100-continue"
+ *
+ * Called after the request headers are parsed and before any of the request body is read, so that a request that
+ * will be refused does not transfer its body. Request headers and query parameters can be looked up as in \ref url_processor_t.
+ *
+ * @param[in] url_path           : URL path.
+ * @param[in] url_query_string   : NULL terminated URL query string.
+ * @param[in] stream             : HTTP stream on which the request was received.
+ * @param[in] arg                : Argument registered with the resource.
+ * @param[in] http_data          : Request type, MIME type and length of the announced request body.
+ *
+ * @return cy_http_status_codes_t : CY_HTTP_200_TYPE to accept the body; the server replies "100 Continue" and calls the
+ *                                  URL processor. A 4xx/5xx status (for example, CY_HTTP_413_TYPE) is sent as the final
+ *                                  response and the connection is closed without reading the body.
+ */
+typedef cy_http_status_codes_t (*cy_http_expect_handler_t)( const char *url_path, const char *url_query_string, cy_http_response_stream_t *stream, void *arg, const cy_http_message_body_t *http_data );
+
 /** Dynamic HTTP resource info */
 typedef struct cy_resource_dynamic_data_s
 {
-    url_processor_t resource_handler;       /**< The function that will handle requests for this page */
-    void            *arg;                   /**< Argument to be passed to the generator function    */
+    url_processor_t          resource_handler;  /**< The function that will handle requests for this page */
+    void                     *arg;              /**< Argument to be passed to the generator function    */
+    cy_http_expect_handler_t expect_handler;    /**< Optional; decides on "Expect: 100-continue" requests before their body is read. NULL accepts them all */
 } cy_resource_dynamic_data_t;
 
 /** Static HTTP resource info */
@@ -342,6 +562,90 @@ typedef struct cy_resource_static_data_s
     uint32_t    length;                     /**< The length in bytes of the page/file */
 } cy_resource_static_data_t;
 
+/** HTTP resource registered by \ref cy_http_server_register_resources */
+typedef struct cy_http_resource_s
+{
+    const char           *url;                /**< URL of the resource; see \ref cy_http_server_register_resource */
+    const char           *mime_type;          /**< MIME type of the resource */
+    cy_url_resource_type url_resource_type;   /**< Content type of the resource */
+    void                 *resource_data;      /**< Pointer to a \ref cy_resource_static_data_t or \ref cy_resource_dynamic_data_t */
+    uint8_t              methods;             /**< Request methods taken, as passed to \ref cy_http_server_set_resource_methods; 0 to leave them unset */
+} cy_http_resource_t;
+
+/**
+ * Prototype for the form decoder field callback.
+ * A field value may be passed in several parts; the callback is called with is_last set to true for the last part, which may be empty.
+ *
+ * @param[in] arg                : Argument passed to \ref cy_http_server_form_decoder_init.
+ * @param[in] key                : Decoded field name; not NULL-terminated.
+ * @param[in] key_length         : Length of the field name.
+ * @param[in] value              : Next part of the decoded field value; not NULL-terminated.
+ * @param[in] value_length       : Length of this part of the value.
+ * @param[in] is_last            : true if this is the last part of the value.
+ */
+typedef void (*cy_http_form_field_callback_t)( void *arg, const char *key, uint32_t key_length, const char *value, uint32_t value_length, bool is_last );
+
+/**
+ * Prototype for the multipart parser part header callback. Called once for each header line of a part, before any data of the part.
+ *
+ * @param[in] arg                : Argument passed to \ref cy_http_server_multipart_parser_init.
+ * @param[in] name               : Header name; not NULL-terminated.
+ * @param[in] name_length        : Length of the header name.
+ * @param[in] value              : Header value without surrounding whitespace; not NULL-terminated.
+ * @param[in] value_length       : Length of the header value.
+ */
+typedef void (*cy_http_multipart_header_callback_t)( void *arg, const char *name, uint32_t name_length, const char *value, uint32_t value_length );
+
+/**
+ * Prototype for the multipart parser part data callback.
+ * The data of a part is passed in several parts as it arrives; the callback is called with is_last set to true at the end of each part, possibly with no data.
+ *
+ * @param[in] arg                : Argument passed to \ref cy_http_server_multipart_parser_init.
+ * @param[in] data               : Next part data.
+ * @param[in] length             : Length of the data.
+ * @param[in] is_last            : true if this is the end of the part.
+ */
+typedef void (*cy_http_multipart_data_callback_t)( void *arg, const uint8_t *data, uint32_t length, bool is_last );
+
+/**
+ * Streaming parser for multipart/form-data message bodies.
+ * Users should not access these values - they are provided here only
+ * to provide the compiler with datatype size information that allows static declarations.
+ */
+typedef struct
+{
+    cy_http_multipart_header_callback_t header_callback;                                         /**< Part header callback */
+    cy_http_multipart_data_callback_t   data_callback;                                           /**< Part data callback */
+    void                                *arg;                                                    /**< Argument passed to the callbacks */
+    uint8_t                             state;                                                   /**< Parser state */
+    uint8_t                             delimiter[ HTTP_SERVER_MULTIPART_MAX_BOUNDARY_LENGTH + 4 ]; /**< CRLF "--" boundary */
+    uint32_t                            delimiter_length;                                        /**< Length of the delimiter */
+    uint8_t                             skip[ 256 ];                                             /**< Boyer-Moore-Horspool shift table for the delimiter */
+    uint8_t                             lookbehind[ HTTP_SERVER_MULTIPART_MAX_BOUNDARY_LENGTH + 4 ]; /**< Bytes of a possible delimiter that started in an earlier fragment */
+    uint32_t                            lookbehind_length;                                       /**< Number of bytes in lookbehind[] */
+    char                                header_line[ HTTP_SERVER_MULTIPART_MAX_HEADER_LENGTH ];  /**< Part header line being received */
+    uint32_t                            header_line_length;                                      /**< Number of bytes in header_line[] */
+} cy_http_multipart_parser_t;
+
+/**
+ * Streaming decoder for application/x-www-form-urlencoded message bodies.
+ * Users should not access these values - they are provided here only
+ * to provide the compiler with datatype size information that allows static declarations.
+ */
+typedef struct
+{
+    cy_http_form_field_callback_t callback;                                  /**< Field callback */
+    void                          *arg;                                      /**< Argument passed to the field callback */
+    char                          key[ HTTP_SERVER_FORM_MAX_KEY_LENGTH ];    /**< Decoded name of the current field */
+    uint32_t                      key_length;                                /**< Length of the decoded name */
+    char                          value[ HTTP_SERVER_FORM_VALUE_BUFFER_SIZE ]; /**< Decoded value bytes not yet passed to the callback */
+    uint32_t                      value_length;                              /**< Number of bytes in value[] */
+    bool                          in_value;                                  /**< The current field name has been followed by '=' */
+    uint8_t                       escape_length;                             /**< Number of characters of a "%XX" escape seen so far */
+    uint8_t                       escape_value;                              /**< High nibble of the escape being decoded */
+    bool                          failed;                                    /**< Malformed body seen; further data is rejected */
+} cy_http_form_decoder_t;
+
 /**
  * @}
  */
@@ -397,6 +701,69 @@ cy_rslt_t cy_http_server_create( cy_network_interface_t *interface,
                                  cy_https_server_security_info_t *security_info,
                                  cy_http_server_t *server_handle );
 
+/**
+ * Number of reassembly buffers of a server accepting max_connection connections
+ */
+#if ( HTTP_SERVER_REASSEMBLY_BUFFER_COUNT == 0 )
+#define CY_HTTP_SERVER_REASSEMBLY_BUFFERS( max_connection ) \
+    ( (uint32_t)(max_connection) )
+#else
+#define CY_HTTP_SERVER_REASSEMBLY_BUFFERS( max_connection ) \
+    ( ( (uint32_t)(max_connection) < HTTP_SERVER_REASSEMBLY_BUFFER_COUNT ) ? (uint32_t)(max_connection) : HTTP_SERVER_REASSEMBLY_BUFFER_COUNT )
+#endif
+
+/**
+ * Size in bytes of the memory to pass to \ref cy_http_server_create_static for a server accepting max_connection
+ * connections. It is a constant expression, so it can size a statically allocated buffer; it may exceed the exact size
+ * returned by \ref cy_http_server_get_static_memory_size by the margin in \ref HTTP_SERVER_STATIC_SERVER_OVERHEAD and
+ * \ref HTTP_SERVER_STATIC_CONNECTION_OVERHEAD.
+ */
+#define CY_HTTP_SERVER_STATIC_MEMORY_SIZE( max_connection ) \
+    ( HTTP_SERVER_STATIC_SERVER_OVERHEAD + ( HTTP_SERVER_STATIC_RESOURCE_OVERHEAD * MAX_NUMBER_OF_HTTP_SERVER_RESOURCES ) + \
+      ( (uint32_t)(max_connection) * HTTP_SERVER_STATIC_CONNECTION_OVERHEAD ) + \
+      ( CY_HTTP_SERVER_REASSEMBLY_BUFFERS( max_connection ) * HTTP_SERVER_REASSEMBLY_BUFFER_SIZE ) + \
+      HTTP_SERVER_CONNECT_THREAD_STACK_SIZE + HTTP_SERVER_EVENT_THREAD_STACK_SIZE )
+
+/**
+ * Creates a HTTP server instance like \ref cy_http_server_create, but in memory provided by the application instead
+ * of the heap. The memory holds the server instance, and when the server is started its connections, request buffers
+ * and thread stacks, so that starting and running the server does not use the heap. It must stay valid until the
+ * server is deleted.
+ *
+ * \note The response header of static resources is not prebuilt for a server created with this function.
+ *
+ * @param[in] interface          : Pointer to the network interface information structure (included as part of cy_nw_helper.h). Used for server start.
+ * @param[in] port               : Port number on which the server listens for client connection requests.
+ * @param[in] max_connection     : Maximum number of client connections that can be accepted.
+ * @param[in] security_info      : Security info containing the certificate, private key, and rootCA certificate.
+ *                                 For a non-secured connection, this parameter should be NULL.
+ * @param[in] memory             : Memory for the server, aligned to 8 bytes.
+ * @param[in] memory_size        : Size of memory in bytes; at least the size returned by \ref cy_http_server_get_static_memory_size,
+ *                                 which \ref CY_HTTP_SERVER_STATIC_MEMORY_SIZE always covers.
+ * @param[out] server_handle     : Pointer to store the HTTP sever handle on successful return.
+ *
+ * @return cy_rslt_t             : CY_RSLT_SUCCESS on success; CY_RSLT_HTTP_SERVER_ERROR_NO_MEMORY if memory is too small;
+ *                                 error codes in @ref http_server_defines otherwise.
+**/
+cy_rslt_t cy_http_server_create_static( cy_network_interface_t *interface,
+                                        uint16_t port,
+                                        uint16_t max_connection,
+                                        cy_https_server_security_info_t *security_info,
+                                        void *memory,
+                                        uint32_t memory_size,
+                                        cy_http_server_t *server_handle );
+
+/**
+ * Returns the exact size of the memory that \ref cy_http_server_create_static needs for a server accepting
+ * max_connection connections.
+ *
+ * @param[in]  max_connection    : Maximum number of client connections that can be accepted.
+ * @param[out] size              : Size in bytes.
+ *
+ * @return cy_rslt_t             : CY_RSLT_SUCCESS on success; error codes in @ref http_server_defines otherwise.
+**/
+cy_rslt_t cy_http_server_get_static_memory_size( uint16_t max_connection, uint32_t *size );
+
 /**
  * Deletes the given HTTP server instance and resources allocated for the instance by the \ref cy_http_server_create function.
  * Before calling this API function, the HTTP server associated with server_handle must be stopped.
@@ -431,7 +798,20 @@ cy_rslt_t cy_http_server_stop( cy_http_server_t server_handle );
 
 /**
  * Used to register a resource(static/dynamic) with the HTTP server.
- * All static resources must have been registered before calling \ref cy_http_server_start.
+ * Resources may be registered while the server is running. Requests received after this API returns are served by the
+ * new resource; requests being served are not affected.
+ *
+ * A '*' at the end of the URL matches any rest of the request URL, and a '*' between two '/' matches any one path
+ * segment. A request is served by the resource with the longest literal match, so an exact URL is preferred to a
+ * wildcard one whatever the order of registration. URLs with '?' or with '*' inside a segment are matched as glob
+ * patterns, after all other URLs. Resources registered before the server was stopped are dropped, and must be
+ * registered again before it is restarted.
+ *
+ * A path segment "{name}" matches any one segment like '*', and passes it to the URL handler as a path parameter; see
+ * \ref cy_http_server_get_path_parameters. "{name:u32}" only matches a decimal number up to 4294967295 and "{name:hex}"
+ * up to 8 hexadecimal digits; the value is converted while the URL is matched. Typed segments are tried before untyped
+ * ones. A URL with more than \ref HTTP_SERVER_MAX_PATH_PARAMETERS segments of '{name}' and '*' is refused, and so is
+ * one whose path passes more than 16 points where other resources branch off with a wildcard.
  *
  * @param[in] server_handle       : HTTP server handle created using \ref cy_http_server_create.
  * @param[in] url                 : URL of the resource. The application should reserve memory for the URL.
@@ -443,6 +823,113 @@ cy_rslt_t cy_http_server_stop( cy_http_server_t server_handle );
  */
 cy_rslt_t cy_http_server_register_resource( cy_http_server_t server_handle, uint8_t *url, uint8_t *mime_type, cy_url_resource_type url_resource_type, void *resource_data );
 
+/**
+ * Registers several resources with the HTTP server at once, as \ref cy_http_server_register_resource would one by one.
+ * The resources are added to the resource database in a single update, so registering a fixed set of resources this
+ * way costs one copy of the database rather than one per resource. Either all resources are registered or none is.
+ * \note The array may be freed once this API returns; the URL, MIME type and data of each resource must remain valid
+ *       as for \ref cy_http_server_register_resource.
+ *
+ * @param[in] server_handle       : HTTP server handle created using \ref cy_http_server_create.
+ * @param[in] resources           : Resources to register, in order of registration.
+ * @param[in] count               : Number of resources.
+ *
+ * @return cy_rslt_t              : CY_RSLT_SUCCESS on success; error codes in @ref http_server_defines otherwise.
+ */
+cy_rslt_t cy_http_server_register_resources( cy_http_server_t server_handle, const cy_http_resource_t *resources, uint16_t count );
+
+/**
+ * Unregisters all resources registered with a URL. Resources may be unregistered while the server is running: requests
+ * received after this API returns no longer find them, while a request still being received by one of them completes.
+ * The URL, MIME type and data of an unregistered resource must remain valid until the server is stopped, as a request
+ * being served may still use them.
+ * \note This API and \ref cy_http_server_register_resource must not be called from several threads at the same time.
+ *       A server created with \ref cy_http_server_create_static returns CY_RSLT_HTTP_SERVER_ERROR_NO_MEMORY from
+ *       either API while the resources replaced by the previous call are still being used by a request.
+ *
+ * @param[in] server_handle       : HTTP server handle created using \ref cy_http_server_create.
+ * @param[in] url                 : URL the resources were registered with; compared as a string.
+ *
+ * @return cy_rslt_t              : CY_RSLT_SUCCESS on success; CY_RSLT_HTTP_SERVER_ERROR_NOT_FOUND if no resource has the URL;
+ *                                  error codes in @ref http_server_defines otherwise.
+ */
+cy_rslt_t cy_http_server_unregister_resource( cy_http_server_t server_handle, const uint8_t *url );
+
+/**
+ * Sets the request methods taken by all resources registered with a URL. A request with any other method is answered
+ * "405 Method Not Allowed" with an Allow header listing the methods set, without calling the URL processor; OPTIONS
+ * requests list them too. Until this API is called, GET, POST and PUT requests reach every resource, HEAD is taken by
+ * CY_STATIC_URL_CONTENT and CY_DYNAMIC_URL_CONTENT resources, and DELETE and PATCH by none; a URL processor only
+ * receives DELETE, PATCH, or HEAD for a CY_RAW_DYNAMIC_URL_CONTENT resource once they are set here. OPTIONS is always
+ * taken, and methods only a URL processor can answer are dropped from the set of a static resource. A server created with \ref cy_http_server_create builds the 405
+ * response here, so it is sent with a single write.
+ * \note This API may be called while the server is running, under the same conditions as \ref cy_http_server_unregister_resource.
+ *
+ * @param[in] server_handle       : HTTP server handle created using \ref cy_http_server_create.
+ * @param[in] url                 : URL the resources were registered with; compared as a string.
+ * @param[in] methods             : \ref CY_HTTP_METHOD_BIT of each request type taken, e.g.
+ *                                  CY_HTTP_METHOD_BIT( CY_HTTP_REQUEST_GET ) | CY_HTTP_METHOD_BIT( CY_HTTP_REQUEST_POST ).
+ *
+ * @return cy_rslt_t              : CY_RSLT_SUCCESS on success; CY_RSLT_HTTP_SERVER_ERROR_NOT_FOUND if no resource has the URL;
+ *                                  error codes in @ref http_server_defines otherwise.
+ */
+cy_rslt_t cy_http_server_set_resource_methods( cy_http_server_t server_handle, const uint8_t *url, uint8_t methods );
+
+/**
+ * Selects the request headers to be made available to URL handlers through \ref cy_http_server_get_request_header.
+ * Headers not in the list are skipped by the parser and cannot be looked up. By default, all headers are made available.
+ * \note This API must be called before \ref cy_http_server_start. The header name strings are not copied and must remain valid while the server is running.
+ *
+ * @param[in] server_handle       : HTTP server handle created using \ref cy_http_server_create.
+ * @param[in] header_names        : Array of NULL-terminated header names; matched case-insensitively.
+ * @param[in] count               : Number of header names; at most \ref HTTP_SERVER_MAX_REQUEST_HEADERS. Pass 0 to make all headers available again.
+ *
+ * @return cy_rslt_t              : CY_RSLT_SUCCESS on success; error codes from @ref http_server_defines otherwise.
+ */
+cy_rslt_t cy_http_server_set_request_header_interest( cy_http_server_t server_handle, const char **header_names, uint32_t count );
+
+/**
+ * Sets the max number of bytes read from a connection at a time. A connection with more data pending is read again
+ * until none is left, so data is not lost whatever the size; a larger size needs fewer reads for large request
+ * bodies, at the cost of a larger part of a reassembly buffer. The default is \ref HTTP_SERVER_MTU_SIZE.
+ * \note The size may be changed while the server is running. A read is never larger than \ref HTTP_SERVER_MTU_SIZE
+ *       while all reassembly buffers are held by connections with an incomplete request header.
+ *
+ * @param[in] server_handle       : HTTP server handle created using \ref cy_http_server_create.
+ * @param[in] size                : Size in bytes; at least 1 and at most the smaller of \ref HTTP_SERVER_REASSEMBLY_BUFFER_SIZE and 65535.
+ *
+ * @return cy_rslt_t              : CY_RSLT_SUCCESS on success; error codes from @ref http_server_defines otherwise.
+ */
+cy_rslt_t cy_http_server_set_receive_size( cy_http_server_t server_handle, uint32_t size );
+
+/**
+ * Sets the memory budgets for incomplete request headers. A request whose header is not complete when its connection
+ * holds connection_budget bytes is answered "431 Request Header Fields Too Large"; one that would take the bytes held
+ * by all connections over total_budget is answered "503 Service Unavailable". The connection is closed in both cases,
+ * so one client sending large or slow headers cannot take the buffers needed by the others. The defaults are
+ * \ref HTTP_SERVER_CONNECTION_MEMORY_BUDGET and \ref HTTP_SERVER_TOTAL_MEMORY_BUDGET.
+ * \note The budgets may be changed while the server is running. Request bodies are passed to the URL handlers as they
+ *       are received and are not held, so they are not counted.
+ *
+ * @param[in] server_handle       : HTTP server handle created using \ref cy_http_server_create.
+ * @param[in] connection_budget   : Bytes per connection; at least 1 and at most \ref HTTP_SERVER_REASSEMBLY_BUFFER_SIZE.
+ * @param[in] total_budget        : Bytes for all connections together; 0 for no limit.
+ *
+ * @return cy_rslt_t              : CY_RSLT_SUCCESS on success; error codes from @ref http_server_defines otherwise.
+ */
+cy_rslt_t cy_http_server_set_memory_budget( cy_http_server_t server_handle, uint32_t connection_budget, uint32_t total_budget );
+
+/**
+ * Gets the memory held by the connections of a running server for incomplete request headers, and the number of
+ * requests refused for exceeding the budgets set with \ref cy_http_server_set_memory_budget.
+ *
+ * @param[in]  server_handle      : HTTP server handle created using \ref cy_http_server_create.
+ * @param[out] usage              : Memory usage, counted since the server was last started.
+ *
+ * @return cy_rslt_t              : CY_RSLT_SUCCESS on success; error codes from @ref http_server_defines otherwise.
+ */
+cy_rslt_t cy_http_server_get_memory_usage( cy_http_server_t server_handle, cy_http_server_memory_usage_t *usage );
+
 /**
  * Enables chunked transfer encoding on the HTTP stream.
  *
@@ -538,6 +1025,9 @@ cy_rslt_t cy_http_server_get_query_parameter_value( const char *url_query, const
 
 /**
  * Returns the number of parameters found in the URL query string.
+ * \note The string passed to a URL handler has each key and value decoded, so a parameter with an escaped '&' counts as
+ *       several here. \ref cy_http_server_get_query_parameter_count_by_stream reads the count of the request, split
+ *       before it was decoded, without rescanning the string.
  *
  * @param[in] url_query           : NULL terminated URL query string.
  * @param[out] count              : Parameter count.
@@ -556,6 +1046,221 @@ cy_rslt_t cy_http_server_get_query_parameter_count( const char *url_query, uint3
  * @return cy_rslt_t              : CY_RSLT_SUCCESS if matched; CY_RSLT_NOT_FOUND if matching parameter is not found.
  */
 cy_rslt_t cy_http_server_match_query_parameter( const char *url_query, const char *parameter_key, const char *parameter_value );
+
+/**
+ * Initializes a streaming decoder for an application/x-www-form-urlencoded message body.
+ * The decoder holds a bounded amount of state, so a body of any size can be decoded as it arrives in \ref cy_http_message_body_t fragments.
+ *
+ * @param[out] decoder            : Decoder to be initialized.
+ * @param[in]  callback           : Called for each decoded field.
+ * @param[in]  arg                : Argument passed to the callback.
+ *
+ * @return cy_rslt_t              : CY_RSLT_SUCCESS on success; error codes from @ref http_server_defines otherwise.
+ */
+cy_rslt_t cy_http_server_form_decoder_init( cy_http_form_decoder_t *decoder, cy_http_form_field_callback_t callback, void *arg );
+
+/**
+ * Decodes the next fragment of a form body. A fragment may end anywhere, including inside a field name or a "%XX" escape.
+ *
+ * @param[in] decoder             : Decoder initialized with \ref cy_http_server_form_decoder_init.
+ * @param[in] data                : Body fragment.
+ * @param[in] length              : Length of the body fragment.
+ *
+ * @return cy_rslt_t              : CY_RSLT_SUCCESS on success; CY_RSLT_ERROR if the body is malformed or a field name is longer than \ref HTTP_SERVER_FORM_MAX_KEY_LENGTH.
+ */
+cy_rslt_t cy_http_server_form_decoder_process( cy_http_form_decoder_t *decoder, const uint8_t *data, uint32_t length );
+
+/**
+ * Completes decoding of a form body and passes the last field to the callback.
+ *
+ * @param[in] decoder             : Decoder initialized with \ref cy_http_server_form_decoder_init.
+ *
+ * @return cy_rslt_t              : CY_RSLT_SUCCESS on success; CY_RSLT_ERROR if the body is malformed.
+ */
+cy_rslt_t cy_http_server_form_decoder_finish( cy_http_form_decoder_t *decoder );
+
+/**
+ * Decodes the body data passed to a URL handler, and completes decoding once the whole body has been received.
+ * To be called from the URL handler (\ref url_processor_t) for every part of the request body.
+ *
+ * @param[in] decoder             : Decoder initialized with \ref cy_http_server_form_decoder_init.
+ * @param[in] http_data           : Message body passed to the URL handler.
+ *
+ * @return cy_rslt_t              : CY_RSLT_SUCCESS on success; CY_RSLT_ERROR if the body is malformed.
+ */
+cy_rslt_t cy_http_server_form_decoder_process_body( cy_http_form_decoder_t *decoder, const cy_http_message_body_t *http_data );
+
+/**
+ * Returns the boundary parameter of a multipart Content-Type request header. To be called from the URL handler (\ref url_processor_t).
+ * \note If \ref cy_http_server_set_request_header_interest is used, "Content-Type" must be one of the headers of interest.
+ *
+ * @param[in]  stream             : Response stream passed to the URL handler.
+ * @param[out] boundary           : Points to the boundary upon return, without quotes; not NULL-terminated. NULL if not found.
+ * @param[out] boundary_length    : Length of the boundary upon return; 0 if not found.
+ *
+ * @return cy_rslt_t              : CY_RSLT_SUCCESS if found; CY_RSLT_HTTP_SERVER_ERROR_NOT_FOUND otherwise.
+ */
+cy_rslt_t cy_http_server_get_multipart_boundary( cy_http_response_stream_t *stream, char **boundary, uint32_t *boundary_length );
+
+/**
+ * Initializes a streaming parser for a multipart/form-data message body.
+ * The parser holds a bounded amount of state, so parts of any size are passed to the application as they arrive.
+ *
+ * @param[out] parser             : Parser to be initialized.
+ * @param[in]  boundary           : Boundary from the Content-Type header; see \ref cy_http_server_get_multipart_boundary. It is copied into the parser.
+ * @param[in]  boundary_length    : Length of the boundary; at most \ref HTTP_SERVER_MULTIPART_MAX_BOUNDARY_LENGTH.
+ * @param[in]  header_callback    : Called for each part header; may be NULL.
+ * @param[in]  data_callback      : Called with the data of each part.
+ * @param[in]  arg                : Argument passed to the callbacks.
+ *
+ * @return cy_rslt_t              : CY_RSLT_SUCCESS on success; error codes from @ref http_server_defines otherwise.
+ */
+cy_rslt_t cy_http_server_multipart_parser_init( cy_http_multipart_parser_t *parser, const char *boundary, uint32_t boundary_length,
+                                                cy_http_multipart_header_callback_t header_callback, cy_http_multipart_data_callback_t data_callback, void *arg );
+
+/**
+ * Parses the next fragment of a multipart body. A fragment may end anywhere, including inside a boundary or a part header.
+ *
+ * @param[in] parser              : Parser initialized with \ref cy_http_server_multipart_parser_init.
+ * @param[in] data                : Body fragment.
+ * @param[in] length              : Length of the body fragment.
+ *
+ * @return cy_rslt_t              : CY_RSLT_SUCCESS on success; CY_RSLT_ERROR if the body is malformed or a part header line is longer than \ref HTTP_SERVER_MULTIPART_MAX_HEADER_LENGTH.
+ */
+cy_rslt_t cy_http_server_multipart_parser_process( cy_http_multipart_parser_t *parser, const uint8_t *data, uint32_t length );
+
+/**
+ * Completes parsing of a multipart body.
+ *
+ * @param[in] parser              : Parser initialized with \ref cy_http_server_multipart_parser_init.
+ *
+ * @return cy_rslt_t              : CY_RSLT_SUCCESS if the closing boundary has been received; CY_RSLT_ERROR otherwise.
+ */
+cy_rslt_t cy_http_server_multipart_parser_finish( cy_http_multipart_parser_t *parser );
+
+/**
+ * Parses the body data passed to a URL handler, and completes parsing once the whole body has been received.
+ * To be called from the URL handler (\ref url_processor_t) for every part of the request body.
+ *
+ * @param[in] parser              : Parser initialized with \ref cy_http_server_multipart_parser_init.
+ * @param[in] http_data           : Message body passed to the URL handler.
+ *
+ * @return cy_rslt_t              : CY_RSLT_SUCCESS on success; CY_RSLT_ERROR if the body is malformed or incomplete.
+ */
+cy_rslt_t cy_http_server_multipart_parser_process_body( cy_http_multipart_parser_t *parser, const cy_http_message_body_t *http_data );
+
+/**
+ * Looks up a URL query parameter of the request being processed by its exact key. To be called from the URL handler (\ref url_processor_t).
+ * The query string is split once before the URL handler is called, so each lookup does not rescan it. It is split
+ * before each key and value is decoded, so an escaped '&' or '=' stays part of the value it is in.
+ * Use \ref cy_http_server_get_query_parameter_value to match keys against a wildcard pattern.
+ *
+ * \note The value is not copied and is not NULL-terminated; it is valid only until the URL handler returns.
+ *
+ * @param[in]  stream             : Response stream passed to the URL handler.
+ * @param[in]  parameter_key      : NULL-terminated key of the parameter; matched case-sensitively.
+ * @param[out] parameter_value    : If the parameter is found and has a value, this pointer will point to the value upon return; NULL otherwise.
+ * @param[out] value_length       : This variable will contain the length of the value upon return; 0 otherwise.
+ *
+ * @return cy_rslt_t              : CY_RSLT_SUCCESS if found; CY_RSLT_HTTP_SERVER_ERROR_NOT_FOUND otherwise.
+ */
+cy_rslt_t cy_http_server_get_query_parameter_by_key( cy_http_response_stream_t *stream, const char *parameter_key, char **parameter_value, uint32_t *value_length );
+
+/**
+ * Returns the path parameters of the request being processed, captured while its URL was matched against the route
+ * template of the resource; one per '{name}' or '*' segment, in URL order. To be called from the URL handler (\ref url_processor_t).
+ *
+ * \note The values point into the request URL and are not NULL-terminated; they are valid only until the URL handler returns.
+ *       Path parameters are not available when the URL handler is called again with the remaining data of a request that spans several packets.
+ *
+ * @param[in]  stream             : Response stream passed to the URL handler.
+ * @param[out] parameters         : Points to the array of path parameters upon return.
+ * @param[out] count              : Number of path parameters upon return; 0 if the route has none.
+ *
+ * @return cy_rslt_t              : CY_RSLT_SUCCESS on success; error codes from @ref http_server_defines otherwise.
+ */
+cy_rslt_t cy_http_server_get_path_parameters( cy_http_response_stream_t *stream, const cy_http_path_parameter_t **parameters, uint32_t *count );
+
+/**
+ * Looks up a path parameter of the request being processed by the name of its '{name}' segment in the route template.
+ * To be called from the URL handler (\ref url_processor_t).
+ *
+ * \note The value is not copied and is not NULL-terminated; it is valid only until the URL handler returns.
+ *
+ * @param[in]  stream             : Response stream passed to the URL handler.
+ * @param[in]  name               : NULL-terminated name of the parameter; matched case-sensitively.
+ * @param[out] parameter          : Points to the path parameter upon return; NULL if not found.
+ *
+ * @return cy_rslt_t              : CY_RSLT_SUCCESS if found; CY_RSLT_HTTP_SERVER_ERROR_NOT_FOUND otherwise.
+ */
+cy_rslt_t cy_http_server_get_path_parameter( cy_http_response_stream_t *stream, const char *name, const cy_http_path_parameter_t **parameter );
+
+/**
+ * Returns the URL query parameter at the given position in the query string of the request being processed. To be called from the URL handler (\ref url_processor_t).
+ *
+ * \note The key and value are not copied and are not NULL-terminated; they are valid only until the URL handler returns.
+ *
+ * @param[in]  stream             : Response stream passed to the URL handler.
+ * @param[in]  position           : Zero-based position of the parameter; less than \ref HTTP_SERVER_MAX_QUERY_PARAMETERS.
+ * @param[out] parameter_key      : Points to the key of the parameter upon return; NULL if not found.
+ * @param[out] key_length         : Length of the key upon return; 0 if not found.
+ * @param[out] parameter_value    : Points to the value of the parameter upon return; NULL if not found or the parameter has no value.
+ * @param[out] value_length       : Length of the value upon return; 0 if not found or the parameter has no value.
+ *
+ * @return cy_rslt_t              : CY_RSLT_SUCCESS if found; CY_RSLT_HTTP_SERVER_ERROR_NOT_FOUND otherwise.
+ */
+cy_rslt_t cy_http_server_get_query_parameter_by_position( cy_http_response_stream_t *stream, uint32_t position, char **parameter_key, uint32_t *key_length, char **parameter_value, uint32_t *value_length );
+
+/**
+ * Returns the number of URL query parameters of the request being processed, including any beyond
+ * \ref HTTP_SERVER_MAX_QUERY_PARAMETERS. To be called from the URL handler (\ref url_processor_t). The count is read from
+ * the query index built before the URL handler is called.
+ *
+ * @param[in]  stream             : Response stream passed to the URL handler.
+ * @param[out] count              : Number of parameters upon return; 0 if the URL has no query string.
+ *
+ * @return cy_rslt_t              : CY_RSLT_SUCCESS on success; error codes from @ref http_server_defines otherwise.
+ */
+cy_rslt_t cy_http_server_get_query_parameter_count_by_stream( cy_http_response_stream_t *stream, uint32_t *count );
+
+/**
+ * Looks up a header of the request being processed. To be called from the URL handler (\ref url_processor_t).
+ *
+ * \note The value is not copied and is not NULL-terminated; it points into the receive buffer and is valid only until the URL handler returns.
+ *       Headers are not available when the URL handler is called again with the remaining data of a request that spans several packets.
+ *
+ * @param[in]  stream             : Response stream passed to the URL handler.
+ * @param[in]  header_name        : NULL-terminated header name; matched case-insensitively.
+ * @param[out] header_value       : If the header is found, this pointer will point to the header value upon return; NULL otherwise.
+ * @param[out] value_length       : This variable will contain the length of the header value upon return; 0 otherwise.
+ *
+ * @return cy_rslt_t              : CY_RSLT_SUCCESS if found; CY_RSLT_HTTP_SERVER_ERROR_NOT_FOUND otherwise.
+ */
+cy_rslt_t cy_http_server_get_request_header( cy_http_response_stream_t *stream, const char *header_name, char **header_value, uint32_t *value_length );
+
+/**
+ * Stops the server from reading further parts of the request body on this stream. To be called from the URL handler
+ * (\ref url_processor_t), or from another thread while the request body is being received.
+ *
+ * \note Unread data stays in the socket, so the TCP receive window closes and the client stops sending until
+ *       \ref cy_http_server_request_body_resume is called.
+ *
+ * @param[in] stream              : Response stream passed to the URL handler.
+ *
+ * @return cy_rslt_t              : CY_RSLT_SUCCESS on success; error codes in @ref http_server_defines otherwise.
+ */
+cy_rslt_t cy_http_server_request_body_pause( cy_http_response_stream_t *stream );
+
+/**
+ * Resumes reading the request body on a stream paused with \ref cy_http_server_request_body_pause.
+ * May be called from any thread; the stream is resumed, and the URL handler called with the next part, by the HTTP
+ * server event thread. If this API fails, the stream stays paused and the call may be repeated.
+ *
+ * @param[in] stream              : Response stream passed to the URL handler.
+ *
+ * @return cy_rslt_t              : CY_RSLT_SUCCESS on success; error codes in @ref http_server_defines otherwise.
+ */
+cy_rslt_t cy_http_server_request_body_resume( cy_http_response_stream_t *stream );
 /**
  * @}
  */
@@ -38,6 +38,7 @@
 
 #include <string.h>
 #include <stdlib.h>
+#include <stddef.h>
 #ifndef COMPONENT_55900
 #include <cmsis_compiler.h>
 #endif
@@ -45,11 +46,33 @@
 #include "cy_http_server.h"
 #include "cy_log.h"
 
+/* Vector instruction set used for delimiter scanning. Define HTTP_SERVER_DISABLE_SIMD_SCAN to use the portable 64-bit SWAR scan. */
+#if !defined( HTTP_SERVER_DISABLE_SIMD_SCAN )
+#if defined( __AVX2__ )
+#include <immintrin.h>
+#define HTTP_SERVER_SCAN_USE_AVX2
+#define HTTP_SERVER_SCAN_USE_SSE2
+#elif defined( __SSE2__ ) || defined( _M_X64 )
+#include <emmintrin.h>
+#define HTTP_SERVER_SCAN_USE_SSE2
+#elif defined( __ARM_FEATURE_MVE ) && ( ( __ARM_FEATURE_MVE & 1 ) != 0 )
+#include <arm_mve.h>
+#define HTTP_SERVER_SCAN_USE_MVE
+#elif defined( __ARM_NEON ) || defined( __ARM_NEON__ )
+#include <arm_neon.h>
+#define HTTP_SERVER_SCAN_USE_NEON
+#endif
+#endif
+#if defined( HTTP_SERVER_SCAN_USE_SSE2 ) && defined( _MSC_VER )
+#include <intrin.h>   /* _BitScanForward */
+#endif
+
 
 /******************************************************
  *                      Macros
  ******************************************************/
 #define EXPAND_AS_MIME_TABLE(a,b)    b,
+#define EXPAND_AS_MIME_LENGTH(a,b)   ( sizeof( b ) - 1 ),
 
 #ifdef ENABLE_HTTP_SERVER_LOGS
 #define hs_cy_log_msg cy_log_msg
@@ -66,30 +89,16 @@
 /******************************************************
  *                    Constants
  ******************************************************/
-#ifndef HTTP_SERVER_MTU_SIZE
-#define HTTP_SERVER_MTU_SIZE                  (1460)
-#endif
-
 /* Socket receive timeout in milliseconds */
 #ifndef HTTP_SERVER_SOCKET_RECEIVE_TIMEOUT
 #define HTTP_SERVER_SOCKET_RECEIVE_TIMEOUT    (10)
 #endif
 
-#ifndef HTTP_SERVER_CONNECT_THREAD_STACK_SIZE
-#if defined(__llvm__)
-#define HTTP_SERVER_CONNECT_THREAD_STACK_SIZE (8 * 1024)
-#else
-#define HTTP_SERVER_CONNECT_THREAD_STACK_SIZE (7 * 1024)
-#endif
-#endif
+/* Largest read from a connection; a received packet is passed to the receive callback with a 16-bit length */
+#define HTTP_SERVER_MAX_RECEIVE_SIZE          ( ( HTTP_SERVER_REASSEMBLY_BUFFER_SIZE < 0xFFFF ) ? HTTP_SERVER_REASSEMBLY_BUFFER_SIZE : 0xFFFF )
 
-#ifndef HTTP_SERVER_EVENT_THREAD_STACK_SIZE
-#if defined(__llvm__)
-#define HTTP_SERVER_EVENT_THREAD_STACK_SIZE   (10 * 1024)
-#else
-#define HTTP_SERVER_EVENT_THREAD_STACK_SIZE   (8 * 1024)
-#endif
-#endif
+/* Rounds up the size of each part of the memory of a server created with cy_http_server_create_static */
+#define HTTP_SERVER_STATIC_ALIGN( size )      ( ( (uint32_t)(size) + 7u ) & ~7u )
 
 #define HTTP_SERVER_THREAD_PRIORITY       (CY_RTOS_PRIORITY_NORMAL)
 #define HTTP_SERVER_RECEIVE_TIMEOUT       (cy_NO_WAIT)
@@ -98,6 +107,11 @@
 #define GET_TOKEN                         "GET "
 #define POST_TOKEN                        "POST "
 #define PUT_TOKEN                         "PUT "
+#define HEAD_TOKEN                        "HEAD "
+#define DELETE_TOKEN                      "DELETE "
+#define PATCH_TOKEN                       "PATCH "
+#define OPTIONS_TOKEN                     "OPTIONS "
+#define OPTIONS_ASTERISK_URL              "*"
 
 #define HTTP_1_1_TOKEN                    " HTTP/1.1"
 #define FINAL_CHUNKED_PACKET              "0\r\n\r\n"
@@ -113,10 +127,70 @@
 #define COMPARE_MATCH                     (0)
 #define MAX_URL_LENGTH                    (100)
 
-/* Most of the webserver supports request length 2KB to 8KB.
- * We may thus assume that 8KB is the maximum possible length
- * and 2KB is a more affordable length to rely on at the server side */
-#define MAXIMUM_CACHED_LENGTH             (8192)
+/* Number of hash buckets in the per-request header index; kept at twice the number of entries so probe chains stay short */
+#define HTTP_HEADER_INDEX_BUCKETS         ( 2 * HTTP_SERVER_MAX_REQUEST_HEADERS )
+#define HTTP_HEADER_HASH_OFFSET_BASIS     (2166136261UL)
+#define HTTP_HEADER_HASH_PRIME            (16777619UL)
+
+#if ( HTTP_SERVER_MAX_REQUEST_HEADERS < 1 ) || ( HTTP_SERVER_MAX_REQUEST_HEADERS > 127 )
+#error "HTTP_SERVER_MAX_REQUEST_HEADERS must be between 1 and 127"
+#endif
+
+/* Route trie: a route adds at most two nodes per literal part (one to split an existing edge) and one per wildcard
+ * segment. A route that no longer fits is refused, so that a route set is grown or a static server fails to register it.
+ */
+#define HTTP_ROUTE_NODES_FOR(capacity)    ( ( 3 * (capacity) ) + 1 )
+#define HTTP_ROUTE_MAX_NODES              HTTP_ROUTE_NODES_FOR( MAX_NUMBER_OF_HTTP_SERVER_RESOURCES )
+#define HTTP_ROUTE_NODES_NEEDED(segments) ( ( 3 * (segments) ) + 2 )
+#define HTTP_ROUTE_ROOT                   (0)
+#define HTTP_ROUTE_NONE                   (0xFFFF)
+/* Nodes with wildcards still to be tried that a URL lookup remembers; a route passing more of them is refused */
+#define HTTP_ROUTE_MAX_WILDCARD_DEPTH     (16)
+
+/* Types of the path segments matched by a segment node of the route trie */
+#define HTTP_ROUTE_SEGMENT_ANY            (0)
+#define HTTP_ROUTE_SEGMENT_U32            (1)
+#define HTTP_ROUTE_SEGMENT_HEX            (2)
+#define HTTP_ROUTE_U32_TOKEN              "u32"
+#define HTTP_ROUTE_HEX_TOKEN              "hex"
+
+/* Memory of a route set with room for capacity pages, laid out as in http_server_route_set_init */
+#define HTTP_ROUTE_SET_SIZE(capacity)     ( sizeof( cy_http_route_set_t ) + ( (capacity) * sizeof( cy_http_page_t ) ) + \
+                                            ( HTTP_ROUTE_NODES_FOR(capacity) * sizeof( cy_http_route_node_t ) ) + \
+                                            ( 2 * (capacity) * sizeof( uint16_t ) ) )
+/* Most pages of a server created with cy_http_server_create, whose route set grows as resources are registered */
+#define HTTP_ROUTE_MAX_CAPACITY           ( ( HTTP_ROUTE_NONE - 2 ) / 3 )
+
+/* Orders the writes that fill a route set before the write that publishes it to the event thread */
+#if defined( __GNUC__ )
+#define HTTP_ROUTE_PUBLISH_BARRIER()      __atomic_thread_fence( __ATOMIC_SEQ_CST )
+#else
+#define HTTP_ROUTE_PUBLISH_BARRIER()      __DMB()
+#endif
+
+#if ( HTTP_ROUTE_MAX_NODES >= HTTP_ROUTE_NONE )
+#error "MAX_NUMBER_OF_HTTP_SERVER_RESOURCES is too large for the route table"
+#endif
+
+#if ( HTTP_SERVER_CONNECTION_MEMORY_BUDGET < 1 ) || ( HTTP_SERVER_CONNECTION_MEMORY_BUDGET > HTTP_SERVER_REASSEMBLY_BUFFER_SIZE )
+#error "HTTP_SERVER_CONNECTION_MEMORY_BUDGET must be between 1 and HTTP_SERVER_REASSEMBLY_BUFFER_SIZE"
+#endif
+
+/* Sets of request methods accepted by a route, one bit per cy_http_request_type_t */
+#define HTTP_METHOD_BIT(type)             CY_HTTP_METHOD_BIT( type )
+#define HTTP_STATIC_METHODS               ( HTTP_METHOD_BIT( CY_HTTP_REQUEST_GET ) | HTTP_METHOD_BIT( CY_HTTP_REQUEST_HEAD ) | \
+                                            HTTP_METHOD_BIT( CY_HTTP_REQUEST_OPTIONS ) )
+#define HTTP_RAW_STATIC_METHODS           ( HTTP_METHOD_BIT( CY_HTTP_REQUEST_GET ) | HTTP_METHOD_BIT( CY_HTTP_REQUEST_OPTIONS ) )
+/* DELETE and PATCH, and HEAD for a raw page, only reach a URL processor once set with cy_http_server_set_resource_methods */
+#define HTTP_RAW_DYNAMIC_METHODS          ( HTTP_UNCHECKED_METHODS | HTTP_METHOD_BIT( CY_HTTP_REQUEST_OPTIONS ) )
+#define HTTP_DYNAMIC_METHODS              ( HTTP_RAW_DYNAMIC_METHODS | HTTP_METHOD_BIT( CY_HTTP_REQUEST_HEAD ) )
+#define HTTP_ALL_METHODS                  ( HTTP_METHOD_BIT( CY_HTTP_REQUEST_UNDEFINED ) - 1U )
+/* Methods passed to every page whose methods are not set by the application */
+#define HTTP_UNCHECKED_METHODS            ( HTTP_METHOD_BIT( CY_HTTP_REQUEST_GET ) | HTTP_METHOD_BIT( CY_HTTP_REQUEST_POST ) | \
+                                            HTTP_METHOD_BIT( CY_HTTP_REQUEST_PUT ) )
+
+/* Large enough for the status line, the Allow header listing every method and the closing sequence */
+#define HTTP_ALLOW_RESPONSE_SIZE          (192)
 
 #define CY_VERIFY(x)                      {cy_rslt_t res = (cy_rslt_t)(x); if (res != CY_RSLT_SUCCESS){return res;}}
 
@@ -133,10 +207,15 @@
 #define HTTP_HEADER_405                   "HTTP/1.1 405 Method Not Allowed"
 #define HTTP_HEADER_406                   "HTTP/1.1 406 Not Acceptable"
 #define HTTP_HEADER_412                   "HTTP/1.1 412 Precondition Failed"
+#define HTTP_HEADER_413                   "HTTP/1.1 413 Payload Too Large"
+#define HTTP_HEADER_417                   "HTTP/1.1 417 Expectation Failed"
 #define HTTP_HEADER_429                   "HTTP/1.1 429 Too Many Requests"
+#define HTTP_HEADER_431                   "HTTP/1.1 431 Request Header Fields Too Large"
 #define HTTP_HEADER_444                   "HTTP/1.1 444"
 #define HTTP_HEADER_470                   "HTTP/1.1 470 Connection Authorization Required"
 #define HTTP_HEADER_500                   "HTTP/1.1 500 Internal Server Error"
+#define HTTP_HEADER_501                   "HTTP/1.1 501 Not Implemented"
+#define HTTP_HEADER_503                   "HTTP/1.1 503 Service Unavailable"
 #define HTTP_HEADER_504                   "HTTP/1.1 504 Not Able to Connect"
 #define HTTP_HEADER_CONTENT_LENGTH        "Content-Length: "
 #define HTTP_HEADER_CONTENT_TYPE          "Content-Type: "
@@ -145,6 +224,7 @@
 #define HTTP_HEADER_ACCEPT                "Accept: "
 #define HTTP_HEADER_KEEP_ALIVE            "Connection: Keep-Alive"
 #define HTTP_HEADER_CLOSE                 "Connection: close"
+#define HTTP_HEADER_ALLOW                 "Allow: "
 #define NO_CACHE_HEADER                   "Cache-Control: no-store, no-cache, must-revalidate, post-check=0, pre-check=0\r\n"\
                                           "Pragma: no-cache"
 #define CRLF                              "\r\n"
@@ -152,6 +232,22 @@
 #define LFLF                              "\n\n"
 #define EVENT_STREAM_DATA                 "data: "
 
+/* Request header names and values recognized by the request parser (compared case-insensitively) */
+#define HTTP_CONTENT_TYPE_NAME            "Content-Type"
+#define HTTP_CONTENT_LENGTH_NAME          "Content-Length"
+#define HTTP_TRANSFER_ENCODING_NAME       "Transfer-Encoding"
+#define HTTP_CONNECTION_NAME              "Connection"
+#define HTTP_EXPECT_NAME                  "Expect"
+#define HTTP_CHUNKED_TOKEN                "chunked"
+#define HTTP_CLOSE_TOKEN                  "close"
+#define HTTP_100_CONTINUE_TOKEN           "100-continue"
+#define HTTP_100_CONTINUE_RESPONSE        "HTTP/1.1 100 Continue\r\n\r\n"
+
+#define HTTP_MULTIPART_DELIMITER_PREFIX   "\r\n--"
+#define HTTP_MULTIPART_BOUNDARY_PARAMETER "boundary="
+
+#define HTTP_TO_LOWER(c)                  ( ( ( (c) >= 'A' ) && ( (c) <= 'Z' ) ) ? (char)( (c) + ( 'a' - 'A' ) ) : (c) )
+
 /******************************************************
  *                   Enumerations
  ******************************************************/
@@ -162,7 +258,9 @@ typedef enum
     CY_SOCKET_DISCONNECT_EVENT,
     CY_SOCKET_PACKET_RECEIVED_EVENT,
     CY_SERVER_STOP_EVENT,
-    CY_SERVER_CONNECT_EVENT
+    CY_SERVER_CONNECT_EVENT,
+    CY_SERVER_ROUTES_EVENT,
+    CY_SERVER_RESUME_EVENT
 } cy_http_server_event_t;
 
 typedef enum
@@ -172,6 +270,50 @@ typedef enum
     CY_HTTP_ERROR_STATE
 } cy_http_packet_state_t;
 
+/* States of the incremental request header parser. Values below CY_HTTP_PARSER_COMPLETE need more data. */
+typedef enum
+{
+    CY_HTTP_PARSER_REQUEST_LINE = 0,     /* Scanning the request line                  */
+    CY_HTTP_PARSER_LINE_LF,              /* CR seen, expecting LF                       */
+    CY_HTTP_PARSER_HEADER_START,         /* Start of a header line or of the empty line */
+    CY_HTTP_PARSER_HEADER_NAME,          /* Scanning a header name                      */
+    CY_HTTP_PARSER_HEADER_VALUE_START,   /* Skipping whitespace after ':'               */
+    CY_HTTP_PARSER_HEADER_VALUE,         /* Scanning a header value                     */
+    CY_HTTP_PARSER_HEADERS_END_LF,       /* CR of the empty line seen, expecting LF     */
+    CY_HTTP_PARSER_COMPLETE,             /* Header section fully parsed                 */
+    CY_HTTP_PARSER_ERROR                 /* Malformed request                           */
+} cy_http_parser_state_t;
+
+/* States of the chunked transfer coding decoder */
+typedef enum
+{
+    CY_HTTP_CHUNKED_NONE = 0,              /* Request body is not chunked                    */
+    CY_HTTP_CHUNKED_SIZE,                  /* Receiving the chunk size                       */
+    CY_HTTP_CHUNKED_EXTENSION,             /* Skipping chunk extensions                      */
+    CY_HTTP_CHUNKED_SIZE_LF,               /* CR after the chunk size line seen              */
+    CY_HTTP_CHUNKED_DATA,                  /* Receiving chunk data                           */
+    CY_HTTP_CHUNKED_DATA_CR,               /* Expecting CRLF after the chunk data            */
+    CY_HTTP_CHUNKED_DATA_LF,               /* CR after the chunk data seen                   */
+    CY_HTTP_CHUNKED_TRAILER_START,         /* Start of a trailer line or of the empty line   */
+    CY_HTTP_CHUNKED_TRAILER_LINE,          /* Skipping a trailer line                        */
+    CY_HTTP_CHUNKED_TRAILER_END_LF,        /* CR of the empty line seen                      */
+    CY_HTTP_CHUNKED_DONE,                  /* Last chunk and trailers received               */
+    CY_HTTP_CHUNKED_ERROR                  /* Malformed chunked body                         */
+} cy_http_chunked_state_t;
+
+/* States of the multipart body parser */
+typedef enum
+{
+    CY_HTTP_MULTIPART_PREAMBLE = 0,        /* Skipping data before the first boundary        */
+    CY_HTTP_MULTIPART_AFTER_BOUNDARY,      /* Boundary seen, expecting CRLF or "--"          */
+    CY_HTTP_MULTIPART_AFTER_BOUNDARY_DASH, /* First '-' of the closing "--" seen             */
+    CY_HTTP_MULTIPART_AFTER_BOUNDARY_CR,   /* CR after the boundary seen, expecting LF       */
+    CY_HTTP_MULTIPART_HEADERS,             /* Receiving part headers                         */
+    CY_HTTP_MULTIPART_DATA,                /* Receiving part data                            */
+    CY_HTTP_MULTIPART_EPILOGUE,            /* Closing boundary seen; remaining data ignored  */
+    CY_HTTP_MULTIPART_ERROR                /* Malformed body                                 */
+} cy_http_multipart_state_t;
+
 /******************************************************
  *                 Type Definitions
  ******************************************************/
@@ -192,15 +334,135 @@ typedef cy_rslt_t ( *cy_http_server_disconnect_callback_t )( cy_http_response_st
 
 typedef struct cy_http_page_s cy_http_page_t;
 
+/**
+ * Location of one request header within the request
+ */
+typedef struct
+{
+    uint32_t                  hash;                 /**< FNV-1a hash of the lower-cased header name */
+    uint32_t                  name_offset;          /**< Offset of the header name */
+    uint32_t                  name_length;          /**< Length of the header name */
+    uint32_t                  value_offset;         /**< Offset of the header value */
+    uint32_t                  value_length;         /**< Length of the header value, excluding surrounding whitespace */
+} cy_http_header_entry_t;
+
+/**
+ * Fixed-capacity hashed index of the request headers.
+ * Entries hold offsets only; nothing is copied out of the receive buffer.
+ */
+typedef struct
+{
+    const char                *base;                                        /**< Request the offsets refer to; NULL when the header is no longer available */
+    uint8_t                   count;                                        /**< Number of entries in use */
+    uint8_t                   buckets[ HTTP_HEADER_INDEX_BUCKETS ];         /**< Entry index + 1 for each hash bucket; 0 marks an empty bucket */
+    cy_http_header_entry_t    entries[ HTTP_SERVER_MAX_REQUEST_HEADERS ];   /**< Indexed headers in the order received */
+} cy_http_header_index_t;
+
+/**
+ * Request headers the application wants indexed. When empty, every header is indexed.
+ */
+typedef struct
+{
+    const char                *names[ HTTP_SERVER_MAX_REQUEST_HEADERS ];        /**< Header names; owned by the application */
+    uint32_t                  name_lengths[ HTTP_SERVER_MAX_REQUEST_HEADERS ]; /**< Length of each header name */
+    uint32_t                  hashes[ HTTP_SERVER_MAX_REQUEST_HEADERS ];       /**< Hash of each lower-cased header name */
+    uint32_t                  count;                                           /**< Number of header names */
+    uint32_t                  length_mask;                                     /**< Bit n is set if a name has length n; bit 31 stands for all lengths from 31 up */
+    uint32_t                  hash_mask;                                       /**< Bit ( hash % 32 ) is set for each name */
+} cy_http_header_interest_t;
+
+/**
+ * Resumable request header parser state.
+ * All offsets are relative to the first byte of the request, so parsing can resume
+ * on a buffer that has grown since the previous call without rescanning it.
+ */
+typedef struct
+{
+    cy_http_parser_state_t    state;                /**< Current parser state */
+    uint32_t                  offset;               /**< Number of bytes scanned so far */
+    uint32_t                  request_line_length;  /**< Length of the request line excluding CRLF */
+    uint32_t                  header_length;        /**< Length of the header section including the empty line */
+    uint32_t                  line_start;           /**< Offset of the header line being parsed */
+    uint32_t                  name_length;          /**< Length of the header name being parsed */
+    uint32_t                  value_start;          /**< Offset of the header value being parsed */
+    uint32_t                  content_type_offset;  /**< Offset of the Content-Type value */
+    uint32_t                  content_type_length;  /**< Length of the Content-Type value; 0 if not present */
+    uint32_t                  content_length;       /**< Value of the Content-Length header */
+    bool                      has_content_length;   /**< Content-Length header is present */
+    bool                      is_chunked;           /**< Transfer-Encoding is chunked */
+    bool                      has_transfer_encoding; /**< Transfer-Encoding header is present */
+    bool                      connection_close;     /**< Connection: close is requested */
+    bool                      expect_continue;      /**< Expect: 100-continue is requested */
+    bool                      expect_unsupported;   /**< Expect header holds an expectation other than 100-continue */
+    const cy_http_header_interest_t *interest;      /**< Headers to be indexed */
+    cy_http_header_index_t    headers;              /**< Index of the request headers */
+} cy_http_request_parser_t;
+
+/**
+ * Location of one URL query parameter within the query string
+ */
+typedef struct
+{
+    uint32_t                  hash;                 /**< FNV-1a hash of the key */
+    uint32_t                  key_offset;           /**< Offset of the key */
+    uint32_t                  key_length;           /**< Length of the key */
+    uint32_t                  value_offset;         /**< Offset of the value */
+    uint32_t                  value_length;         /**< Length of the value */
+    bool                      has_value;            /**< The key is followed by '=' */
+} cy_http_query_entry_t;
+
+/**
+ * Index of the URL query parameters, built once before the URL handler is called
+ */
+typedef struct
+{
+    const char                *base;                                            /**< Query string the offsets refer to; NULL when no request is being dispatched */
+    uint32_t                  count;                                            /**< Number of parameters in the query string */
+    uint32_t                  indexed_count;                                    /**< Number of parameters in entries[] */
+    cy_http_query_entry_t     entries[ HTTP_SERVER_MAX_QUERY_PARAMETERS ];      /**< Parameters in the order they appear */
+} cy_http_query_index_t;
+
+/**
+ * Chunked transfer coding decoder state, kept across received packets
+ */
+typedef struct
+{
+    cy_http_chunked_state_t   state;                /**< Current decoder state */
+    uint32_t                  chunk_remaining;      /**< Size of the chunk being received, then bytes of it still to come */
+    bool                      has_size;             /**< At least one digit of the chunk size has been received */
+} cy_http_chunked_decoder_t;
+
+/**
+ * Buffer in which a request header split across packets is reassembled
+ */
+typedef struct
+{
+    cy_linked_list_node_t     node;                                         /**< Node in the list of free buffers */
+    uint32_t                  length;                                       /**< Number of bytes received so far */
+    char                      data[ HTTP_SERVER_REASSEMBLY_BUFFER_SIZE ];   /**< Start of the request */
+} cy_http_reassembly_buffer_t;
+
 /**
  * HTTP server request info sent as part of the request callback
  */
 typedef struct
 {
+   /* Used for every received packet; kept together at the start, next to the response stream */
    cy_http_page_t            *page_found;     /**< Pointer to the found page/resource */
    uint32_t                  data_remaining;  /**< Number of bytes remaining to be sent to the application */
    cy_http_mime_type_t       mime_type;       /**< Mime type of the request */
    cy_http_request_type_t    request_type;    /**< Request type */
+   cy_http_chunked_decoder_t chunked;         /**< Decoder for a chunked request body */
+   volatile bool             receive_paused;  /**< URL handler asked for no more request body for now; may be set from any thread */
+   bool                      receive_drain;   /**< Data left in the socket while paused is still being read; used by the event thread only */
+   cy_http_reassembly_buffer_t *reassembly;   /**< Incomplete request header received so far; NULL if none */
+   uint32_t                  memory_held;     /**< Bytes of reassembly counted against the memory budgets */
+
+   /* Used only while a request header is parsed and its URL handler runs */
+   cy_http_request_parser_t  parser;          /**< Header parser state, kept across received packets */
+   cy_http_query_index_t     query;           /**< URL query parameters of the request */
+   cy_http_path_parameter_t  path_parameters[ HTTP_SERVER_MAX_PATH_PARAMETERS ]; /**< Segments captured by the route template */
+   uint8_t                   path_parameter_count; /**< Number of path_parameters set */
 } cy_http_request_info_t;
 
 /**
@@ -211,23 +473,105 @@ struct cy_http_page_s
 {
     char                 *url;                 /**< String containing the path part of the URL of this page/file */
     char                 *mime_type;           /**< String containing the MIME type of this page/file */
+    cy_http_mime_type_t  mime;                 /**< mime_type as found in the MIME table at registration */
     cy_url_resource_type url_content_type;     /**< The page type - this selects which part of the url_content union will be used - also see above */
     union
     {
         struct
         {
-            url_processor_t generator;         /**< The function which will handle requests for this page */
-            void            *arg;              /**< An argument to be passed to the generator function    */
+            url_processor_t          generator;      /**< The function which will handle requests for this page */
+            void                     *arg;           /**< An argument to be passed to the generator function    */
+            cy_http_expect_handler_t expect_handler; /**< Decides on "Expect: 100-continue" requests; may be NULL */
         } dynamic_data;                        /**< Used for CY_DYNAMIC_URL_CONTENT and CY_RAW_DYNAMIC_URL_CONTENT */
         struct
         {
             const void      *ptr;              /**< A pointer to the data for the page/file */
             uint32_t        length;            /**< The length in bytes of the page/file */
+            char            *header;           /**< Response header of a CY_STATIC_URL_CONTENT page, built at registration; NULL if not available */
+            uint32_t        header_length;     /**< Length of the prebuilt response header */
         } static_data;                         /**< Used for CY_STATIC_URL_CONTENT and CY_RAW_STATIC_URL_CONTENT */
         const void          *resource_data;    /**< A Resource containing the page/file - Used for CY_RESOURCE_URL_CONTENT and CY_RAW_RESOURCE_URL_CONTENT */
     } url_content;                             /**< Static/Dynamic URL content */
+    char                 *method_response;     /**< 405 response of a page whose methods are set by the application, built then; NULL if not available */
+    uint16_t             method_response_length; /**< Length of the prebuilt 405 response */
+    uint8_t              methods;              /**< Request methods the page answers, listed in its Allow header; one HTTP_METHOD_BIT() per method */
+    uint8_t              accepted_methods;     /**< Request methods passed on to the page; others are answered 405 */
 };
 
+/**
+ * Node of the route trie. The literal children of a node have labels starting with different characters, so a URL is
+ * matched by following one child per step. Segment children each match one path segment, and are tried in turn.
+ * Labels point into the registered URLs, which are not copied.
+ */
+typedef struct
+{
+    const char                *label;               /**< Part of a registered URL matched by this node; the parameter name for a segment node */
+    uint16_t                  label_length;         /**< Length of label; 0 for the root and for '*' segment nodes */
+    uint16_t                  first_child;          /**< First literal child, or HTTP_ROUTE_NONE */
+    uint16_t                  next_sibling;         /**< Next child of the same kind of the same parent, or HTTP_ROUTE_NONE */
+    uint16_t                  segment_child;        /**< First child matching one path segment, or HTTP_ROUTE_NONE; typed ones come first */
+    uint16_t                  page;                 /**< First page whose URL ends at this node, or HTTP_ROUTE_NONE */
+    uint16_t                  prefix_page;          /**< First page whose URL ends with '*' at this node, or HTTP_ROUTE_NONE */
+    uint8_t                   segment_type;         /**< HTTP_ROUTE_SEGMENT_xxx of a segment node */
+} cy_http_route_node_t;
+
+/**
+ * Routes of the registered resources. A URL made of literal parts, whole path segments of '*' or '{name}' and a final
+ * '*' is kept in a radix trie, so finding it takes time in proportion to the URL length rather than to the number of resources.
+ * Other patterns are matched one by one with match_string_with_wildcard_pattern, after the trie.
+ */
+typedef struct
+{
+    cy_http_route_node_t      *nodes;               /**< Trie nodes; the first is the root */
+    uint16_t                  *next_page;           /**< Next page of the same route, in registration order */
+    uint16_t                  *globs;               /**< Pages not in the trie, in registration order */
+    uint16_t                  node_count;           /**< Number of nodes in use */
+    uint16_t                  max_nodes;            /**< Number of nodes there is room for */
+    uint16_t                  glob_count;           /**< Number of pages in globs */
+} cy_http_route_table_t;
+
+/**
+ * Resources registered with a server and their routes. A set is never changed once published to the event thread:
+ * registering or unregistering a resource builds a new set and publishes it in place of the old one, which the event
+ * thread frees when no request uses it any more. Lookups read the published set without taking a lock.
+ */
+typedef struct cy_http_route_set_s
+{
+    struct cy_http_route_set_s *next;               /**< Next set retired or waiting to be taken by the event thread, in order of retirement */
+    struct cy_http_route_set_s *successor;          /**< Set published in place of this one once it is replaced; shares its pages */
+    cy_http_page_t            *pages;               /**< Registered resources, in registration order */
+    cy_http_route_table_t     routes;               /**< Routes of pages */
+    uint16_t                  resource_count;       /**< Number of pages in use */
+    uint16_t                  capacity;             /**< Number of pages there is room for */
+    volatile bool             in_use;               /**< Published or not yet freed; a set in the memory of a static server is reused once false */
+} cy_http_route_set_t;
+
+/* Node of the route trie whose wildcards are yet to be tried by a URL lookup */
+typedef struct
+{
+    uint32_t                  position;             /* Bytes of the URL matched up to the node */
+    uint16_t                  node;                 /* Node index */
+    uint16_t                  next_segment;         /* Segment child to try next; HTTP_ROUTE_NONE once the prefix wildcard is next */
+    uint8_t                   parameter_count;      /* Path parameters captured up to the node */
+} cy_http_route_frame_t;
+
+/* Kinds of registered URL */
+typedef enum
+{
+    HTTP_ROUTE_TRIE,                       /* Kept in the route trie */
+    HTTP_ROUTE_GLOB,                       /* Matched with match_string_with_wildcard_pattern */
+    HTTP_ROUTE_INVALID                     /* Malformed route template */
+} cy_http_route_kind_t;
+
+/*
+ * Memory budgets of a server; changed by the application while the event thread reads them
+ */
+typedef struct
+{
+    volatile uint32_t         connection;           /* Max bytes of incomplete request header held by one connection */
+    volatile uint32_t         total;                /* Max bytes held by all connections; 0 for no limit */
+} cy_http_memory_budget_t;
+
 /**
  * HTTP server request/response stream info
  */
@@ -270,12 +614,23 @@ typedef struct
     cy_thread_t                            connect_thread;        /**< HTTP server connection request thread */
     cy_mutex_t                             mutex;                 /**< Mutex for critical section */
     volatile bool                          quit;                  /**< Internal quit flag to stop HTTP server */
-    const cy_http_page_t                   *page_database;        /**< Handle to the page/resource database */
+    cy_http_route_set_t * volatile const   *route_set;            /**< Resources published by the application; read once per request */
+    cy_http_route_set_t                    *retired_route_sets;   /**< Sets replaced by the application, oldest first; used by the event thread only */
+    cy_http_route_set_t * volatile         unposted_route_sets;   /**< Sets replaced while the event queue was full, oldest first; guarded by mutex */
+    uint32_t                               posted_route_sets;     /**< Number of replaced sets posted to the event thread; guarded by mutex */
+    uint32_t                               taken_route_sets;      /**< Number of posted sets the event thread has taken; used by the event thread only */
     uint8_t                                *streams;              /**< Pointer to allocated streams for the max connections */
     cy_linked_list_t                       active_stream_list;    /**< List of active streams */
     cy_linked_list_t                       inactive_stream_list;  /**< List of inactive streams */
+    uint8_t                                *reassembly_buffers;   /**< Pointer to allocated request reassembly buffers */
+    cy_linked_list_t                       free_reassembly_list;  /**< List of reassembly buffers not held by a stream */
+    uint8_t                                *static_memory;        /**< Memory provided with cy_http_server_create_static; NULL if allocated from the heap */
     cy_http_server_receive_callback_t      receive_callback;      /**< Internal TCP socket receive callback */
     cy_http_server_disconnect_callback_t   disconnect_callback;   /**< Internal TCP disconnect callback */
+    const cy_http_header_interest_t        *header_interest;      /**< Request headers to be indexed */
+    volatile uint32_t                      receive_size;          /**< Max number of bytes read from a connection at a time */
+    const cy_http_memory_budget_t          *memory_budget;        /**< Limits on the memory held by connections */
+    cy_http_server_memory_usage_t          memory_usage;          /**< Memory held by connections; updated by the event thread only */
 } cy_http_server_info_t;
 
 /*
@@ -288,8 +643,10 @@ typedef struct http_server_object
     uint16_t                         port;
     uint16_t                         max_sockets;
     cy_http_server_info_t            http_server;
-    uint16_t                         resource_count;
-    cy_http_page_t                   page_database[MAX_NUMBER_OF_HTTP_SERVER_RESOURCES];
+    cy_http_route_set_t * volatile   route_set;
+    cy_http_header_interest_t        header_interest;
+    uint32_t                         receive_size;
+    cy_http_memory_budget_t          memory_budget;
     cy_tls_identity_t                identity;
     bool                             is_secure;
     bool                             is_started;
@@ -297,6 +654,28 @@ typedef struct http_server_object
     cy_http_security_info            certificate_info;
 } cy_http_server_object_t ;
 
+/*
+ * Offsets of the parts of the memory of a server created with cy_http_server_create_static. The server object is
+ * at its start.
+ */
+typedef struct
+{
+    uint32_t  route_sets;
+    uint32_t  streams;
+    uint32_t  reassembly_buffers;
+    uint32_t  client_sockets;
+    uint32_t  connect_thread_stack;
+    uint32_t  event_thread_stack;
+    uint32_t  size;
+} cy_http_server_static_layout_t;
+
+/* CY_HTTP_SERVER_STATIC_MEMORY_SIZE must cover the layout, including the padding of its seven parts */
+typedef char http_server_static_server_size_check[ ( ( HTTP_SERVER_STATIC_ALIGN( sizeof(cy_http_server_object_t) ) +
+                                                       ( 2 * HTTP_SERVER_STATIC_ALIGN( HTTP_ROUTE_SET_SIZE( MAX_NUMBER_OF_HTTP_SERVER_RESOURCES ) ) ) + ( 7 * 8 ) ) <=
+                                                     ( HTTP_SERVER_STATIC_SERVER_OVERHEAD + ( HTTP_SERVER_STATIC_RESOURCE_OVERHEAD * MAX_NUMBER_OF_HTTP_SERVER_RESOURCES ) ) ) ? 1 : -1 ];
+typedef char http_server_static_connection_size_check[ ( ( sizeof(cy_stream_node_t) + sizeof(cy_tcp_socket_t) + ( sizeof(cy_http_reassembly_buffer_t) - HTTP_SERVER_REASSEMBLY_BUFFER_SIZE ) ) <=
+                                                         HTTP_SERVER_STATIC_CONNECTION_OVERHEAD ) ? 1 : -1 ];
+
 /******************************************************
  *               Static Function Declarations
  ******************************************************/
@@ -306,11 +685,76 @@ static void                http_server_disconnect_callback( void *socket );
 static void                http_server_receive_callback( void* socket );
 void                       http_server_event_thread_main( cy_thread_arg_t arg );
 void                       http_server_connect_thread_main( cy_thread_arg_t arg );
+static uint32_t            http_server_find_delimiter( const char* buffer, uint32_t length,
+                                                       char d0, char d1, char d2, char d3 );
+static int                 http_server_hex_digit_value( char c );
+static uint32_t            http_server_header_name_hash( const char* name, uint32_t length );
+static bool                http_server_header_name_equals( const char* name1, const char* name2, uint32_t length );
+static void                http_server_header_index_add( cy_http_header_index_t* index, uint32_t hash,
+                                                         uint32_t name_offset, uint32_t name_length,
+                                                         uint32_t value_offset, uint32_t value_length );
+static const cy_http_header_entry_t* http_server_header_index_find( const cy_http_header_index_t* index,
+                                                                   const char* name, uint32_t length );
+static bool                http_server_header_is_of_interest( const cy_http_header_interest_t* interest,
+                                                              const char* name, uint32_t length, uint32_t* hash );
+static cy_rslt_t           http_server_form_decoder_append( cy_http_form_decoder_t* decoder, const char* data, uint32_t length );
+static bool                http_server_token_equals( const char* string, uint32_t length,
+                                                     const char* token, uint32_t token_length );
+static bool                http_server_multipart_search( const cy_http_multipart_parser_t* parser,
+                                                         const uint8_t* data, uint32_t length, uint32_t* position );
+static void                http_server_multipart_delimiter_found( cy_http_multipart_parser_t* parser );
+static uint32_t            http_server_multipart_scan_data( cy_http_multipart_parser_t* parser,
+                                                            const uint8_t* data, uint32_t length );
+static bool                http_server_multipart_process_header_line( cy_http_multipart_parser_t* parser );
+static uint32_t            http_server_string_hash( const char* string, uint32_t length );
+static bool                http_server_query_index_build( cy_http_query_index_t* index, char* query, uint32_t length );
+static const cy_http_query_entry_t* http_server_query_index_find( const cy_http_query_index_t* index,
+                                                                 const char* key, uint32_t length );
+static void                http_server_parser_reset( cy_http_request_parser_t* parser,
+                                                     const cy_http_header_interest_t* interest );
+static cy_http_parser_state_t http_server_parser_execute( cy_http_request_parser_t* parser,
+                                                         const char* buffer, uint32_t length );
+static cy_http_chunked_state_t http_server_chunked_decode( cy_http_chunked_decoder_t* decoder, uint8_t* data,
+                                                           uint32_t length, uint32_t* decoded_length, uint32_t* consumed );
+static bool                http_server_request_body_pending( const cy_http_stream_t* stream );
+static void                http_server_request_body_abandon( cy_http_stream_t* stream );
+static void                http_server_release_reassembly_buffer( cy_http_server_info_t* server, cy_http_stream_t* stream );
+static void                http_server_account_memory( cy_http_server_info_t* server, cy_http_stream_t* stream, uint32_t held );
+static void                http_server_reject_request( cy_http_server_info_t* server, cy_http_stream_t* stream, cy_http_status_codes_t status_code );
+static void                http_server_write_error_response( cy_http_stream_t* stream, cy_http_status_codes_t status_code );
+static char*               http_server_get_receive_buffer( cy_http_server_info_t* server, cy_http_stream_t* stream, char* fallback, uint32_t* size );
+static void                http_server_put_receive_buffer( cy_http_server_info_t* server, cy_http_stream_t* stream );
+static cy_http_status_codes_t http_server_answer_expect_continue( cy_http_stream_t* stream, const cy_http_page_t* page_found, const char* url,
+                                                                  const char* url_query_parameters, const cy_http_message_body_t* http_message_body );
+static cy_rslt_t           http_server_process_request_body( cy_http_stream_t* stream, char* data, uint32_t length, uint32_t* consumed );
+static cy_rslt_t           http_server_parse_request( cy_http_server_info_t* server, cy_http_stream_t* stream, char* data, uint32_t length, uint32_t* consumed );
+static void                http_server_build_static_header( cy_http_page_t* page );
+static void                http_server_route_table_init( cy_http_route_table_t* routes );
+static void                http_server_route_add( cy_http_route_table_t* routes, const char* url, uint16_t page );
+static cy_rslt_t           http_server_route_check( const cy_http_route_table_t* routes, const char* url );
+static bool                http_server_route_set_depth_fits( const cy_http_route_set_t* set );
+static cy_http_route_set_t* http_server_route_set_copy( cy_http_server_object_t* server_obj, uint16_t capacity, const char* removed_url );
+static bool                http_server_route_set_grow( const cy_http_server_object_t* server_obj, uint16_t* capacity );
+static void                http_server_route_set_publish( cy_http_server_object_t* server_obj, cy_http_route_set_t* set );
+static void                http_server_route_set_release( cy_http_server_info_t* server, cy_http_route_set_t* set, const cy_http_route_set_t* successor );
+static void                http_server_release_route_sets( cy_http_server_object_t* server_obj );
+static void                http_server_retire_route_sets( cy_http_server_info_t* server, cy_http_route_set_t* sets );
+static void                http_server_take_unposted_route_sets( cy_http_server_info_t* server );
+static void                http_server_reclaim_route_sets( cy_http_server_info_t* server );
+static void                http_server_get_static_layout( uint16_t max_sockets, cy_http_server_static_layout_t* layout );
+static uint32_t            http_server_format_allow_response( char* response, cy_http_status_codes_t status_code, uint8_t methods );
+static cy_rslt_t           http_server_write_bodyless_response( cy_http_response_stream_t* stream, const char* response, uint32_t length );
+static cy_rslt_t           http_server_write_allow_response( cy_http_response_stream_t* stream, cy_http_status_codes_t status_code, uint8_t methods );
+static cy_rslt_t           http_server_write_method_response( cy_http_response_stream_t* stream, const cy_http_page_t* page );
+static uint8_t             http_server_default_methods( cy_url_resource_type url_resource_type );
+static void                http_server_add_page( cy_http_server_object_t* server_obj, cy_http_route_set_t* set, const cy_http_resource_t* resource );
+static void                http_server_set_page_methods( cy_http_server_object_t* server_obj, cy_http_page_t* page, uint8_t methods );
+static void                http_server_build_method_response( cy_http_page_t* page );
 static cy_rslt_t           http_server_parse_receive_packet( cy_http_server_info_t* server,
                                                              cy_http_stream_t* stream,
                                                              char* data, uint32_t length );
 cy_rslt_t                  http_server_process_url_request( cy_http_stream_t* stream,
-                                                            const cy_http_page_t* page_database,
+                                                            const cy_http_route_set_t* route_set,
                                                             char* url, uint32_t url_length,
                                                              cy_http_message_body_t* http_message_body );
 uint16_t                   http_server_remove_escaped_characters( char* output, uint16_t output_length,
@@ -322,19 +766,26 @@ cy_rslt_t                  http_server_get_request_type_and_url( char* request,
 cy_rslt_t                  http_server_find_url_in_page_database( char* url, uint32_t length,
                                                                   cy_http_message_body_t* http_request,
                                                                   const cy_http_page_t* page_database,
+                                                                  const cy_http_route_table_t* routes,
+                                                                  cy_http_path_parameter_t* parameters,
+                                                                  uint8_t* parameter_count,
                                                                   cy_http_page_t** page_found,
                                                                   cy_http_mime_type_t* mime_type );
 bool                       http_server_compare_stream_socket( cy_linked_list_node_t* node_to_compare, void* user_data );
+static bool                http_server_compare_stream_route_set( cy_linked_list_node_t* node_to_compare, void* user_data );
 static cy_rslt_t           http_internal_server_start( cy_http_server_info_t* server,
                                                        void* network_interface, uint16_t port,
-                                                       uint16_t max_sockets, const cy_http_page_t* page_database,
+                                                       uint16_t max_sockets,
                                                        uint32_t http_thread_stack_size,
                                                        uint32_t server_connect_thread_stack_size,
                                                        cy_server_type_t type, cy_http_security_info* security_info );
 static cy_rslt_t           http_server_start( cy_http_server_info_t *server,
                                               void *network_interface, uint16_t port,
                                               uint16_t max_sockets,
-                                              cy_http_page_t *page_database,
+                                              cy_http_route_set_t * volatile const *route_set,
+                                              const cy_http_header_interest_t *header_interest,
+                                              uint32_t receive_size,
+                                              const cy_http_memory_budget_t *memory_budget,
                                               cy_server_type_t type,
                                               cy_http_security_info *security_info );
 static cy_rslt_t           http_server_stop( cy_http_server_info_t *server, uint16_t max_sockets );
@@ -351,6 +802,11 @@ static const char* const http_mime_array[ MIME_UNSUPPORTED ] =
     MIME_TABLE( EXPAND_AS_MIME_TABLE )
 };
 
+static const uint8_t http_mime_lengths[ MIME_UNSUPPORTED ] =
+{
+    MIME_TABLE( EXPAND_AS_MIME_LENGTH )
+};
+
 static const char* const cy_http_status_codes[ ] =
 {
     [CY_HTTP_200_TYPE] = HTTP_HEADER_200,
@@ -368,11 +824,37 @@ static const char* const cy_http_status_codes[ ] =
     [CY_HTTP_444_TYPE] = HTTP_HEADER_444,
     [CY_HTTP_470_TYPE] = HTTP_HEADER_470,
     [CY_HTTP_500_TYPE] = HTTP_HEADER_500,
-    [CY_HTTP_504_TYPE] = HTTP_HEADER_504
+    [CY_HTTP_504_TYPE] = HTTP_HEADER_504,
+    [CY_HTTP_413_TYPE] = HTTP_HEADER_413,
+    [CY_HTTP_417_TYPE] = HTTP_HEADER_417,
+    [CY_HTTP_431_TYPE] = HTTP_HEADER_431,
+    [CY_HTTP_501_TYPE] = HTTP_HEADER_501,
+    [CY_HTTP_503_TYPE] = HTTP_HEADER_503
+};
+
+/* Request method tokens, including the separating space, indexed by cy_http_request_type_t */
+static const char* const http_method_tokens[ CY_HTTP_REQUEST_UNDEFINED ] =
+{
+    [CY_HTTP_REQUEST_GET]     = GET_TOKEN,
+    [CY_HTTP_REQUEST_POST]    = POST_TOKEN,
+    [CY_HTTP_REQUEST_PUT]     = PUT_TOKEN,
+    [CY_HTTP_REQUEST_HEAD]    = HEAD_TOKEN,
+    [CY_HTTP_REQUEST_DELETE]  = DELETE_TOKEN,
+    [CY_HTTP_REQUEST_PATCH]   = PATCH_TOKEN,
+    [CY_HTTP_REQUEST_OPTIONS] = OPTIONS_TOKEN
+};
+
+static const uint8_t http_method_token_lengths[ CY_HTTP_REQUEST_UNDEFINED ] =
+{
+    [CY_HTTP_REQUEST_GET]     = sizeof( GET_TOKEN ) - 1,
+    [CY_HTTP_REQUEST_POST]    = sizeof( POST_TOKEN ) - 1,
+    [CY_HTTP_REQUEST_PUT]     = sizeof( PUT_TOKEN ) - 1,
+    [CY_HTTP_REQUEST_HEAD]    = sizeof( HEAD_TOKEN ) - 1,
+    [CY_HTTP_REQUEST_DELETE]  = sizeof( DELETE_TOKEN ) - 1,
+    [CY_HTTP_REQUEST_PATCH]   = sizeof( PATCH_TOKEN ) - 1,
+    [CY_HTTP_REQUEST_OPTIONS] = sizeof( OPTIONS_TOKEN ) - 1
 };
 
-static char*  cached_string = NULL;
-static size_t cached_length = 0;
 
 CY_ALIGN(8) uint8_t HTTP_server_thread_stack[HTTP_SERVER_CONNECT_THREAD_STACK_SIZE]     = {0};
 CY_ALIGN(8) uint8_t HTTP_server_event_thread_stack[HTTP_SERVER_EVENT_THREAD_STACK_SIZE] = {0};
@@ -393,6 +875,34 @@ cy_rslt_t cy_http_server_network_deinit( void )
     return cy_tcp_server_network_deinit();
 }
 
+/* Initializes a server object allocated by cy_http_server_create or provided to cy_http_server_create_static */
+static void http_server_object_init( cy_http_server_object_t *server_obj,
+                                     cy_network_interface_t *interface,
+                                     uint16_t port,
+                                     uint16_t max_connection,
+                                     cy_https_server_security_info_t *security_info )
+{
+    /* Clear Server data. */
+    memset( server_obj, 0x00, sizeof( cy_http_server_object_t ) );
+
+    server_obj->nw_interface   = interface;
+    server_obj->port           = port;
+    server_obj->max_sockets    = max_connection;
+    server_obj->route_set      = NULL;
+    server_obj->is_started     = false;
+    server_obj->receive_size   = HTTP_SERVER_MTU_SIZE;
+    server_obj->memory_budget.connection = HTTP_SERVER_CONNECTION_MEMORY_BUDGET;
+    server_obj->memory_budget.total      = HTTP_SERVER_TOTAL_MEMORY_BUDGET;
+
+    if( security_info != NULL )
+    {
+        server_obj->security_credentials = security_info;
+        server_obj->is_secure = true;
+    }
+
+    server_obj->is_initialized = true;
+}
+
 cy_rslt_t cy_http_server_create( cy_network_interface_t *interface,
                                  uint16_t port,
                                  uint16_t max_connection,
@@ -408,24 +918,60 @@ cy_rslt_t cy_http_server_create( cy_network_interface_t *interface,
         return CY_RSLT_HTTP_SERVER_ERROR_NO_MEMORY;
     }
 
-    /* Clear Server data. */
-    memset( server_obj, 0x00, sizeof( cy_http_server_object_t ) );
+    http_server_object_init( server_obj, interface, port, max_connection, security_info );
+    *server_handle = (void *)server_obj;
+    return result;
+}
 
-    server_obj->nw_interface   = interface;
-    server_obj->port           = port;
-    server_obj->max_sockets    = max_connection;
-    server_obj->resource_count = 0;
-    server_obj->is_started     = false;
+cy_rslt_t cy_http_server_create_static( cy_network_interface_t *interface,
+                                        uint16_t port,
+                                        uint16_t max_connection,
+                                        cy_https_server_security_info_t *security_info,
+                                        void *memory,
+                                        uint32_t memory_size,
+                                        cy_http_server_t *server_handle )
+{
+    cy_http_server_object_t *server_obj;
+    cy_http_server_static_layout_t layout;
 
-    if( security_info != NULL )
+    if( ( memory == NULL ) || ( server_handle == NULL ) || ( ( (uintptr_t) memory & 7u ) != 0 ) )
     {
-        server_obj->security_credentials = security_info;
-        server_obj->is_secure = true;
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nInvalid parameter to cy_http_server_create_static" );
+        return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
     }
 
-    server_obj->is_initialized = true;
+    http_server_get_static_layout( max_connection, &layout );
+    if( memory_size < layout.size )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nServer needs %lu bytes of memory, %lu given", (unsigned long) layout.size, (unsigned long) memory_size );
+        return CY_RSLT_HTTP_SERVER_ERROR_NO_MEMORY;
+    }
+
+    server_obj = (cy_http_server_object_t *) memory;
+    http_server_object_init( server_obj, interface, port, max_connection, security_info );
+    server_obj->http_server.static_memory = (uint8_t *) memory;
+
+    /* Both route sets are free to be built into */
+    ( (cy_http_route_set_t *) ( server_obj->http_server.static_memory + layout.route_sets ) )->in_use = false;
+    ( (cy_http_route_set_t *) ( server_obj->http_server.static_memory + layout.route_sets +
+                                HTTP_SERVER_STATIC_ALIGN( HTTP_ROUTE_SET_SIZE( MAX_NUMBER_OF_HTTP_SERVER_RESOURCES ) ) ) )->in_use = false;
     *server_handle = (void *)server_obj;
-    return result;
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_http_server_get_static_memory_size( uint16_t max_connection, uint32_t *size )
+{
+    cy_http_server_static_layout_t layout;
+
+    if( size == NULL )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nInvalid parameter to cy_http_server_get_static_memory_size" );
+        return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
+    }
+
+    http_server_get_static_layout( max_connection, &layout );
+    *size = layout.size;
+    return CY_RSLT_SUCCESS;
 }
 
 cy_rslt_t cy_http_server_start( cy_http_server_t server_handle )
@@ -488,7 +1034,7 @@ cy_rslt_t cy_http_server_start( cy_http_server_t server_handle )
         /* Start secure HTTP server */
         result = http_server_start( &(server_obj->http_server), server_obj->nw_interface,
                                        server_obj->port, server_obj->max_sockets,
-                                       server_obj->page_database, CY_HTTP_SERVER_TYPE_SECURE,
+                                       &(server_obj->route_set), &(server_obj->header_interest), server_obj->receive_size, &(server_obj->memory_budget), CY_HTTP_SERVER_TYPE_SECURE,
                                        &(server_obj->certificate_info) );
         if( result != CY_RSLT_SUCCESS )
         {
@@ -513,7 +1059,7 @@ cy_rslt_t cy_http_server_start( cy_http_server_t server_handle )
         /* Start non-secure HTTP server */
         result = http_server_start( &(server_obj->http_server), server_obj->nw_interface,
                                        server_obj->port, server_obj->max_sockets,
-                                       server_obj->page_database, CY_HTTP_SERVER_TYPE_NON_SECURE, NULL);
+                                       &(server_obj->route_set), &(server_obj->header_interest), server_obj->receive_size, &(server_obj->memory_budget), CY_HTTP_SERVER_TYPE_NON_SECURE, NULL);
         if( result != CY_RSLT_SUCCESS )
         {
             hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nFailed to start HTTP server : %d", (int) result );
@@ -566,14 +1112,15 @@ cy_rslt_t cy_http_server_stop( cy_http_server_t server_handle )
         }
     }
 
-    server_obj->resource_count = 0;
     server_obj->is_started = false;
+    http_server_release_route_sets( server_obj );
     return result;
 }
 
 cy_rslt_t cy_http_server_delete( cy_http_server_t server_handle )
 {
     cy_http_server_object_t *server_obj;
+    bool                    is_static;
     if( server_handle == NULL )
     {
         hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nInvalid parameter to cy_http_server_delete" );
@@ -586,20 +1133,45 @@ cy_rslt_t cy_http_server_delete( cy_http_server_t server_handle )
         hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nServer object not initialized\n" );
         return CY_RSLT_ERROR;
     }
+
+    http_server_release_route_sets( server_obj );
+
     /* Clear Server data. */
+    is_static = ( server_obj->http_server.static_memory != NULL );
     memset( server_obj, 0x00, sizeof( cy_http_server_object_t ) );
-    free( server_handle );
+    if( is_static == false )
+    {
+        free( server_handle );
+    }
     server_handle = NULL;
     return CY_RSLT_SUCCESS;
 }
 
 cy_rslt_t cy_http_server_register_resource( cy_http_server_t server_handle, uint8_t *url, uint8_t *mime_type, cy_url_resource_type url_resource_type, void *resource_data)
+{
+    cy_http_resource_t resource;
+
+    resource.url               = (const char*) url;
+    resource.mime_type         = (const char*) mime_type;
+    resource.url_resource_type = url_resource_type;
+    resource.resource_data     = resource_data;
+    resource.methods           = 0;
+
+    return cy_http_server_register_resources( server_handle, &resource, 1 );
+}
+
+cy_rslt_t cy_http_server_register_resources( cy_http_server_t server_handle, const cy_http_resource_t *resources, uint16_t count )
 {
     cy_http_server_object_t *server_obj;
+    cy_http_route_set_t     *set;
+    cy_rslt_t               result = CY_RSLT_SUCCESS;
+    uint32_t                needed;
+    uint16_t                capacity;
+    uint16_t                i;
 
-    if( server_handle == NULL )
+    if( server_handle == NULL || ( resources == NULL && count != 0 ) )
     {
-        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nInvalid parameter to cy_http_server_register_resource" );
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nInvalid parameter to cy_http_server_register_resources" );
         return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
     }
 
@@ -609,89 +1181,374 @@ cy_rslt_t cy_http_server_register_resource( cy_http_server_t server_handle, uint
         hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nServer object not initialized\n" );
         return CY_RSLT_ERROR;
     }
-    if( server_obj->resource_count > ( MAX_NUMBER_OF_HTTP_SERVER_RESOURCES - 1 ) )
+    for( i = 0; i < count; i++ )
+    {
+        if( ( resources[ i ].url == NULL ) || ( ( resources[ i ].methods & (uint8_t) ~HTTP_ALL_METHODS ) != 0 ) )
+        {
+            hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nInvalid parameter to cy_http_server_register_resources" );
+            return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
+        }
+        if( ( resources[ i ].url_resource_type != CY_DYNAMIC_URL_CONTENT ) && ( resources[ i ].url_resource_type != CY_RAW_DYNAMIC_URL_CONTENT ) &&
+            ( resources[ i ].url_resource_type != CY_STATIC_URL_CONTENT ) && ( resources[ i ].url_resource_type != CY_RAW_STATIC_URL_CONTENT ) )
+        {
+            /* Resources served from a filesystem are not supported */
+            hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nUnsupported resource type %d\n", (int) resources[ i ].url_resource_type );
+            return CY_RSLT_HTTP_SERVER_ERROR_UNSUPPORTED;
+        }
+    }
+    if( count == 0 )
     {
-        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "Maximum number of resources configured are [%d], Please change macro MAX_NUMBER_OF_HTTP_SERVER_RESOURCES\n", MAX_NUMBER_OF_HTTP_SERVER_RESOURCES );
-        return CY_RSLT_HTTP_SERVER_PAGE_DATABASE_FULL;
+        return CY_RSLT_SUCCESS;
     }
 
-    server_obj->page_database[server_obj->resource_count].url_content_type                   = url_resource_type;
-    server_obj->page_database[server_obj->resource_count].mime_type                          = (char*) mime_type;
-    server_obj->page_database[server_obj->resource_count].url                                = (char*) url;
+    capacity = ( server_obj->route_set != NULL ) ? server_obj->route_set->capacity : MAX_NUMBER_OF_HTTP_SERVER_RESOURCES;
+    needed   = ( ( server_obj->route_set != NULL ) ? server_obj->route_set->resource_count : 0U ) + (uint32_t) count;
+    while( needed > capacity )
+    {
+        if( http_server_route_set_grow( server_obj, &capacity ) == false )
+        {
+            hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "Maximum number of resources configured are [%d], Please change macro MAX_NUMBER_OF_HTTP_SERVER_RESOURCES\n", (int) capacity );
+            return CY_RSLT_HTTP_SERVER_PAGE_DATABASE_FULL;
+        }
+    }
 
-    if( url_resource_type == CY_DYNAMIC_URL_CONTENT || url_resource_type == CY_RAW_DYNAMIC_URL_CONTENT )
+    /* The resources are added to a copy of the published routes, which replaces them once complete */
+    for( ;; )
     {
-        cy_resource_dynamic_data_t* dynamic_resource = (cy_resource_dynamic_data_t*) resource_data;
+        set = http_server_route_set_copy( server_obj, capacity, NULL );
+        if( set == NULL )
+        {
+            hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "No memory for the routes of [%d] resources\n", (int) capacity );
+            return CY_RSLT_HTTP_SERVER_ERROR_NO_MEMORY;
+        }
 
-        server_obj->page_database[server_obj->resource_count].url_content.dynamic_data.generator = dynamic_resource->resource_handler;
-        server_obj->page_database[server_obj->resource_count].url_content.dynamic_data.arg       = dynamic_resource->arg;
+        for( i = 0; ( i < count ) && ( result == CY_RSLT_SUCCESS ); i++ )
+        {
+            result = http_server_route_check( &set->routes, resources[ i ].url );
+            if( result == CY_RSLT_SUCCESS )
+            {
+                http_server_add_page( server_obj, set, &resources[ i ] );
+            }
+        }
+        if( ( result != CY_RSLT_HTTP_SERVER_PAGE_DATABASE_FULL ) || ( http_server_route_set_grow( server_obj, &capacity ) == false ) )
+        {
+            break;
+        }
+        http_server_route_set_release( &server_obj->http_server, set, server_obj->route_set );
+        result = CY_RSLT_SUCCESS;
     }
-    else if( url_resource_type == CY_STATIC_URL_CONTENT || url_resource_type == CY_RAW_STATIC_URL_CONTENT )
-    {
-        cy_resource_static_data_t* static_resource = (cy_resource_static_data_t*) resource_data;
 
-        server_obj->page_database[server_obj->resource_count].url_content.static_data.ptr    = static_resource->data;
-        server_obj->page_database[server_obj->resource_count].url_content.static_data.length = static_resource->length;
+    if( result != CY_RSLT_SUCCESS )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "Invalid route template or too many routes : [%s]\n", resources[ i - 1 ].url );
+        http_server_route_set_release( &server_obj->http_server, set, server_obj->route_set );
+        return result;
     }
-    else
+
+    /* A lookup remembers a bounded number of wildcards to go back to, so routes nesting more would never be found */
+    if( http_server_route_set_depth_fits( set ) == false )
     {
-        /*Fixme : Handle case when resource is in filesystem */
-        return CY_RSLT_HTTP_SERVER_ERROR_UNSUPPORTED;
+        http_server_route_set_release( &server_obj->http_server, set, server_obj->route_set );
+        return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
     }
 
-    server_obj->resource_count++;
+    http_server_route_set_publish( server_obj, set );
 
     return CY_RSLT_SUCCESS;
 }
 
-static cy_rslt_t http_server_start( cy_http_server_info_t *server, void *network_interface,
-                                    uint16_t port, uint16_t max_sockets,
-                                    cy_http_page_t *page_database, cy_server_type_t type,
-                                    cy_http_security_info *security_info )
+cy_rslt_t cy_http_server_unregister_resource( cy_http_server_t server_handle, const uint8_t *url )
 {
-    if( server == NULL || page_database == NULL )
+    cy_http_server_object_t *server_obj;
+    cy_http_route_set_t     *set;
+
+    if( server_handle == NULL || url == NULL )
     {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nInvalid parameter to cy_http_server_unregister_resource" );
         return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
     }
 
-    memset( server, 0, sizeof( *server ) );
-    return http_internal_server_start ( server, network_interface, port,
-                                        max_sockets, page_database,
-                                        HTTP_SERVER_EVENT_THREAD_STACK_SIZE,
-                                        HTTP_SERVER_CONNECT_THREAD_STACK_SIZE,
-                                        type, security_info );
+    server_obj = (cy_http_server_object_t *)server_handle;
+    if( server_obj->is_initialized == false )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nServer object not initialized\n" );
+        return CY_RSLT_ERROR;
+    }
+    if( server_obj->route_set == NULL )
+    {
+        return CY_RSLT_HTTP_SERVER_ERROR_NOT_FOUND;
+    }
+
+    set = http_server_route_set_copy( server_obj, server_obj->route_set->capacity, (const char*) url );
+    if( set == NULL )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "No memory for the routes of [%d] resources\n", (int) server_obj->route_set->capacity );
+        return CY_RSLT_HTTP_SERVER_ERROR_NO_MEMORY;
+    }
+
+    if( set->resource_count == server_obj->route_set->resource_count )
+    {
+        http_server_route_set_release( &server_obj->http_server, set, server_obj->route_set );
+        return CY_RSLT_HTTP_SERVER_ERROR_NOT_FOUND;
+    }
+
+    http_server_route_set_publish( server_obj, set );
+
+    return CY_RSLT_SUCCESS;
 }
 
-static cy_rslt_t http_internal_server_start( cy_http_server_info_t *server,
-                                             void *network_interface, uint16_t port,
-                                             uint16_t max_sockets,
-                                             const cy_http_page_t *page_database,
-                                             uint32_t http_thread_stack_size,
-                                             uint32_t server_connect_thread_stack_size,
-                                             cy_server_type_t type,
-                                             cy_http_security_info *security_info )
+cy_rslt_t cy_http_server_set_resource_methods( cy_http_server_t server_handle, const uint8_t *url, uint8_t methods )
 {
-    cy_rslt_t result = CY_RSLT_SUCCESS;
-    cy_stream_node_t* stream_node;
-    uint16_t a;
+    cy_http_server_object_t *server_obj;
+    cy_http_route_set_t     *set;
+    cy_http_page_t          *page;
+    uint16_t                i;
+    bool                    found = false;
 
-    /* Store the inputs database */
-    server->page_database = page_database;
+    if( server_handle == NULL || url == NULL || ( methods & (uint8_t) ~HTTP_ALL_METHODS ) != 0 )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nInvalid parameter to cy_http_server_set_resource_methods" );
+        return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
+    }
 
-    /* Allocate space for response streams and insert them into the inactive stream list */
-    cy_linked_list_init( &server->inactive_stream_list );
-    server->streams = malloc( sizeof(cy_stream_node_t) * max_sockets );
-    if( server->streams == NULL )
+    server_obj = (cy_http_server_object_t *)server_handle;
+    if( server_obj->is_initialized == false )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nServer object not initialized\n" );
+        return CY_RSLT_ERROR;
+    }
+    if( server_obj->route_set == NULL )
     {
+        return CY_RSLT_HTTP_SERVER_ERROR_NOT_FOUND;
+    }
+
+    set = http_server_route_set_copy( server_obj, server_obj->route_set->capacity, NULL );
+    if( set == NULL )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "No memory for the routes of [%d] resources\n", (int) server_obj->route_set->capacity );
         return CY_RSLT_HTTP_SERVER_ERROR_NO_MEMORY;
     }
 
-    memset( server->streams, 0, sizeof(cy_stream_node_t) * max_sockets );
-    stream_node = (cy_stream_node_t*)server->streams;
-    for ( a = 0; a < max_sockets; a++ )
+    for( i = 0; i < set->resource_count; i++ )
     {
-        result = cy_rtos_init_mutex( &(stream_node[a].stream.response.mutex) );
-        if( result != CY_RSLT_SUCCESS )
+        page = &set->pages[ i ];
+        if( strcmp( page->url, (const char*) url ) == COMPARE_MATCH )
+        {
+            http_server_set_page_methods( server_obj, page, methods );
+            found = true;
+        }
+    }
+
+    if( found == false )
+    {
+        http_server_route_set_release( &server_obj->http_server, set, server_obj->route_set );
+        return CY_RSLT_HTTP_SERVER_ERROR_NOT_FOUND;
+    }
+
+    http_server_route_set_publish( server_obj, set );
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_http_server_set_request_header_interest( cy_http_server_t server_handle, const char **header_names, uint32_t count )
+{
+    cy_http_server_object_t   *server_obj;
+    cy_http_header_interest_t *interest;
+    uint32_t                  length;
+    uint32_t                  i;
+
+    if( server_handle == NULL || ( header_names == NULL && count != 0 ) || count > HTTP_SERVER_MAX_REQUEST_HEADERS )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nInvalid parameter to cy_http_server_set_request_header_interest" );
+        return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
+    }
+
+    server_obj = (cy_http_server_object_t *)server_handle;
+    if( server_obj->is_initialized == false )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nServer object not initialized\n" );
+        return CY_RSLT_ERROR;
+    }
+    if( server_obj->is_started == true )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nServer already started\n" );
+        return CY_RSLT_ERROR;
+    }
+
+    interest = &server_obj->header_interest;
+    memset( interest, 0x00, sizeof( cy_http_header_interest_t ) );
+
+    for ( i = 0; i < count; i++ )
+    {
+        if( header_names[i] == NULL )
+        {
+            memset( interest, 0x00, sizeof( cy_http_header_interest_t ) );
+            return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
+        }
+
+        length = (uint32_t) strlen( header_names[i] );
+
+        interest->names[i]        = header_names[i];
+        interest->name_lengths[i] = length;
+        interest->hashes[i]       = http_server_header_name_hash( header_names[i], length );
+        interest->length_mask    |= ( 1UL << ( ( length < 31 ) ? length : 31 ) );
+        interest->hash_mask      |= ( 1UL << ( interest->hashes[i] % 32 ) );
+    }
+    interest->count = count;
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_http_server_set_receive_size( cy_http_server_t server_handle, uint32_t size )
+{
+    cy_http_server_object_t   *server_obj;
+
+    if( server_handle == NULL || size == 0 || size > HTTP_SERVER_MAX_RECEIVE_SIZE )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nInvalid parameter to cy_http_server_set_receive_size" );
+        return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
+    }
+
+    server_obj = (cy_http_server_object_t *)server_handle;
+    if( server_obj->is_initialized == false )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nServer object not initialized\n" );
+        return CY_RSLT_ERROR;
+    }
+
+    /* A running server picks up the new size on its next read */
+    server_obj->receive_size = size;
+    if( server_obj->is_started == true )
+    {
+        server_obj->http_server.receive_size = size;
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_http_server_set_memory_budget( cy_http_server_t server_handle, uint32_t connection_budget, uint32_t total_budget )
+{
+    cy_http_server_object_t   *server_obj;
+
+    if( server_handle == NULL || connection_budget == 0 || connection_budget > HTTP_SERVER_REASSEMBLY_BUFFER_SIZE )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nInvalid parameter to cy_http_server_set_memory_budget" );
+        return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
+    }
+
+    server_obj = (cy_http_server_object_t *)server_handle;
+    if( server_obj->is_initialized == false )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nServer object not initialized\n" );
+        return CY_RSLT_ERROR;
+    }
+
+    /* A running server applies the new budgets from the next packet on */
+    server_obj->memory_budget.connection = connection_budget;
+    server_obj->memory_budget.total      = total_budget;
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_http_server_get_memory_usage( cy_http_server_t server_handle, cy_http_server_memory_usage_t *usage )
+{
+    cy_http_server_object_t   *server_obj;
+
+    if( server_handle == NULL || usage == NULL )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nInvalid parameter to cy_http_server_get_memory_usage" );
+        return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
+    }
+
+    server_obj = (cy_http_server_object_t *)server_handle;
+    if( server_obj->is_initialized == false )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nServer object not initialized\n" );
+        return CY_RSLT_ERROR;
+    }
+
+    /* Counters are updated by the event thread as packets arrive, so they may be a packet behind */
+    *usage = server_obj->http_server.memory_usage;
+
+    return CY_RSLT_SUCCESS;
+}
+
+static cy_rslt_t http_server_start( cy_http_server_info_t *server, void *network_interface,
+                                    uint16_t port, uint16_t max_sockets,
+                                    cy_http_route_set_t * volatile const *route_set,
+                                    const cy_http_header_interest_t *header_interest,
+                                    uint32_t receive_size,
+                                    const cy_http_memory_budget_t *memory_budget,
+                                    cy_server_type_t type,
+                                    cy_http_security_info *security_info )
+{
+    uint8_t *static_memory;
+
+    if( server == NULL || route_set == NULL )
+    {
+        return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
+    }
+
+    /* The server runs in the same memory each time it is started */
+    static_memory = server->static_memory;
+    memset( server, 0, sizeof( *server ) );
+    server->static_memory   = static_memory;
+    server->route_set       = route_set;
+    server->memory_budget   = memory_budget;
+    server->header_interest = header_interest;
+    server->receive_size    = receive_size;
+    return http_internal_server_start ( server, network_interface, port,
+                                        max_sockets,
+                                        HTTP_SERVER_EVENT_THREAD_STACK_SIZE,
+                                        HTTP_SERVER_CONNECT_THREAD_STACK_SIZE,
+                                        type, security_info );
+}
+
+static cy_rslt_t http_internal_server_start( cy_http_server_info_t *server,
+                                             void *network_interface, uint16_t port,
+                                             uint16_t max_sockets,
+                                             uint32_t http_thread_stack_size,
+                                             uint32_t server_connect_thread_stack_size,
+                                             cy_server_type_t type,
+                                             cy_http_security_info *security_info )
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+    cy_stream_node_t* stream_node;
+    cy_http_reassembly_buffer_t* reassembly_buffer;
+    cy_http_server_static_layout_t layout;
+    uint8_t* connect_thread_stack = HTTP_server_thread_stack;
+    uint8_t* event_thread_stack = HTTP_server_event_thread_stack;
+    uint16_t reassembly_count;
+    uint16_t a;
+
+    /* A server created in application memory takes its streams, buffers, sockets and thread stacks from it */
+    if( server->static_memory != NULL )
+    {
+        http_server_get_static_layout( max_sockets, &layout );
+        server->streams                   = server->static_memory + layout.streams;
+        server->reassembly_buffers        = server->static_memory + layout.reassembly_buffers;
+        server->tcp_server.client_sockets = (cy_tcp_socket_t*) ( server->static_memory + layout.client_sockets );
+        connect_thread_stack              = server->static_memory + layout.connect_thread_stack;
+        event_thread_stack                = server->static_memory + layout.event_thread_stack;
+    }
+
+    /* Allocate space for response streams and insert them into the inactive stream list */
+    cy_linked_list_init( &server->inactive_stream_list );
+    if( server->static_memory == NULL )
+    {
+        server->streams = malloc( sizeof(cy_stream_node_t) * max_sockets );
+    }
+    if( server->streams == NULL )
+    {
+        return CY_RSLT_HTTP_SERVER_ERROR_NO_MEMORY;
+    }
+
+    memset( server->streams, 0, sizeof(cy_stream_node_t) * max_sockets );
+    stream_node = (cy_stream_node_t*)server->streams;
+    for ( a = 0; a < max_sockets; a++ )
+    {
+        result = cy_rtos_init_mutex( &(stream_node[a].stream.response.mutex) );
+        if( result != CY_RSLT_SUCCESS )
         {
             hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, " Error in mutex init : %d : %s() \r\n", (int) result, __FUNCTION__ );
             result = CY_RSLT_HTTP_SERVER_ERROR_MUTEX_INIT;
@@ -702,6 +1559,26 @@ static cy_rslt_t http_internal_server_start( cy_http_server_info_t *server,
         cy_linked_list_insert_node_at_rear( &server->inactive_stream_list, &stream_node[a].node );
     }
 
+    /* Allocate the buffers for reassembling split request headers up front, so that receiving never allocates memory */
+    cy_linked_list_init( &server->free_reassembly_list );
+    reassembly_count = (uint16_t) CY_HTTP_SERVER_REASSEMBLY_BUFFERS( max_sockets );
+    if( server->static_memory == NULL )
+    {
+        server->reassembly_buffers = malloc( sizeof(cy_http_reassembly_buffer_t) * reassembly_count );
+    }
+    if( server->reassembly_buffers == NULL )
+    {
+        result = CY_RSLT_HTTP_SERVER_ERROR_NO_MEMORY;
+        goto ERROR_QUEUE_INIT;
+    }
+
+    reassembly_buffer = (cy_http_reassembly_buffer_t*)server->reassembly_buffers;
+    for ( a = 0; a < reassembly_count; a++ )
+    {
+        cy_linked_list_set_node_data( &reassembly_buffer[a].node, (void*)&reassembly_buffer[a] );
+        cy_linked_list_insert_node_at_rear( &server->free_reassembly_list, &reassembly_buffer[a].node );
+    }
+
     /* Create linked-list for holding active response streams */
     cy_linked_list_init( &server->active_stream_list );
 
@@ -730,7 +1607,7 @@ static cy_rslt_t http_internal_server_start( cy_http_server_info_t *server,
     }
 
     /* Create thread to process connect events */
-    result = cy_rtos_thread_create( &server->connect_thread, http_server_connect_thread_main, "connect_thread", HTTP_server_thread_stack,
+    result = cy_rtos_thread_create( &server->connect_thread, http_server_connect_thread_main, "connect_thread", connect_thread_stack,
                                     HTTP_SERVER_CONNECT_THREAD_STACK_SIZE, (cy_thread_priority_t) HTTP_SERVER_THREAD_PRIORITY, (cy_thread_arg_t)server );
     if( result != CY_RSLT_SUCCESS )
     {
@@ -740,7 +1617,7 @@ static cy_rslt_t http_internal_server_start( cy_http_server_info_t *server,
     }
 
     /* Create HTTP server connect thread */
-    result = cy_rtos_thread_create( &server->event_thread, http_server_event_thread_main, "event_thread", HTTP_server_event_thread_stack,
+    result = cy_rtos_thread_create( &server->event_thread, http_server_event_thread_main, "event_thread", event_thread_stack,
                                     HTTP_SERVER_EVENT_THREAD_STACK_SIZE, (cy_thread_priority_t) HTTP_SERVER_THREAD_PRIORITY, (cy_thread_arg_t)server );
     if( result != CY_RSLT_SUCCESS )
     {
@@ -788,12 +1665,19 @@ ERROR_QUEUE_INIT:
     cy_rtos_deinit_queue( &connect_event_queue );
     cy_rtos_deinit_queue( &event_queue );
 
+    cy_linked_list_deinit( &server->free_reassembly_list );
     stream_node = (cy_stream_node_t*)server->streams;
     for ( a = 0; a < max_sockets; a++ )
     {
         cy_rtos_deinit_mutex( &(stream_node[a].stream.response.mutex) );
     }
-    free( server->streams );
+
+    if( server->static_memory == NULL )
+    {
+        free( server->reassembly_buffers );
+        free( server->streams );
+    }
+    server->reassembly_buffers = NULL;
     server->streams = NULL;
     return result;
 }
@@ -862,13 +1746,19 @@ static cy_rslt_t http_server_stop( cy_http_server_info_t *server, uint16_t max_s
     hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, " %s() : ----- ### Delete stream mgmt lists\r\n", __FUNCTION__ );
     cy_linked_list_deinit( &server->inactive_stream_list );
     cy_linked_list_deinit( &server->active_stream_list );
-
+    cy_linked_list_deinit( &server->free_reassembly_list );
     stream_node = (cy_stream_node_t*)server->streams;
     for ( a = 0; a < max_sockets; a++ )
     {
         cy_rtos_deinit_mutex( &(stream_node[a].stream.response.mutex) );
     }
-    free( server->streams );
+
+    if( server->static_memory == NULL )
+    {
+        free( server->reassembly_buffers );
+        free( server->streams );
+    }
+    server->reassembly_buffers = NULL;
     server->streams = NULL;
 
     hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, " %s() : ----- ### Stop event processed successfully\r\n", __FUNCTION__ );
@@ -910,7 +1800,8 @@ cy_rslt_t cy_http_server_response_stream_disable_chunked_transfer( cy_http_respo
     cy_rtos_get_mutex( &stream->mutex, CY_RTOS_NEVER_TIMEOUT );
     hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "\ncy_http_server_response_stream_disable_chunked_transfer- Acquired Mutex %p ", stream->mutex );
 
-    if( stream->chunked_transfer_enabled == true )
+    /* A response to a HEAD request ends with its header */
+    if( ( stream->chunked_transfer_enabled == true ) && ( stream->omit_payload == false ) )
     {
         /* Send final chunked frame */
         result = cy_tcp_stream_write( &stream->tcp_stream, FINAL_CHUNKED_PACKET, sizeof( FINAL_CHUNKED_PACKET ) - 1 );
@@ -1003,17 +1894,169 @@ static uint8_t match_string_with_wildcard_pattern( const char *string, uint32_t
     return ( *current_pattern == '\0' );
 }
 
-static char* strnstrn( const char *s, uint16_t s_len, const char *substr, uint16_t substr_len )
+#if defined( HTTP_SERVER_SCAN_USE_SSE2 )
+/* Returns the index of the first byte that matched in the nonzero mask of a vector comparison */
+static uint32_t http_server_scan_first_match( uint32_t mask )
+{
+#if defined( _MSC_VER )
+    unsigned long index;
+
+    _BitScanForward( &index, mask );
+    return (uint32_t) index;
+#else
+    return (uint32_t) __builtin_ctz( mask );
+#endif
+}
+#endif
+
+/*
+ * Returns the offset of the first byte in buffer[0 .. length) that equals any of d0..d3, or length if there is none.
+ * Callers looking for fewer than four delimiters repeat one of them. The bulk of the buffer is compared a vector
+ * (or a 64-bit word) at a time; the block containing the first match and the tail are resolved byte by byte.
+ */
+static uint32_t http_server_find_delimiter( const char *buffer, uint32_t length, char d0, char d1, char d2, char d3 )
 {
-    for ( ; s_len >= substr_len; s++, s_len-- )
+    uint32_t offset = 0;
+
+#if defined( HTTP_SERVER_SCAN_USE_AVX2 )
     {
-        if( strncmp( s, substr, substr_len ) == 0 )
+        const __m256i v0 = _mm256_set1_epi8( d0 );
+        const __m256i v1 = _mm256_set1_epi8( d1 );
+        const __m256i v2 = _mm256_set1_epi8( d2 );
+        const __m256i v3 = _mm256_set1_epi8( d3 );
+
+        while( ( length - offset ) >= 32 )
         {
-            return (char*)s;
+            __m256i  chunk = _mm256_loadu_si256( (const __m256i*)( buffer + offset ) );
+            __m256i  match = _mm256_or_si256( _mm256_or_si256( _mm256_cmpeq_epi8( chunk, v0 ), _mm256_cmpeq_epi8( chunk, v1 ) ),
+                                              _mm256_or_si256( _mm256_cmpeq_epi8( chunk, v2 ), _mm256_cmpeq_epi8( chunk, v3 ) ) );
+            uint32_t mask  = (uint32_t)_mm256_movemask_epi8( match );
+
+            if( mask != 0 )
+            {
+                return offset + http_server_scan_first_match( mask );
+            }
+            offset += 32;
         }
     }
+#endif
 
-    return NULL;
+#if defined( HTTP_SERVER_SCAN_USE_SSE2 )
+    {
+        const __m128i v0 = _mm_set1_epi8( d0 );
+        const __m128i v1 = _mm_set1_epi8( d1 );
+        const __m128i v2 = _mm_set1_epi8( d2 );
+        const __m128i v3 = _mm_set1_epi8( d3 );
+
+        while( ( length - offset ) >= 16 )
+        {
+            __m128i  chunk = _mm_loadu_si128( (const __m128i*)( buffer + offset ) );
+            __m128i  match = _mm_or_si128( _mm_or_si128( _mm_cmpeq_epi8( chunk, v0 ), _mm_cmpeq_epi8( chunk, v1 ) ),
+                                           _mm_or_si128( _mm_cmpeq_epi8( chunk, v2 ), _mm_cmpeq_epi8( chunk, v3 ) ) );
+            uint32_t mask  = (uint32_t)_mm_movemask_epi8( match );
+
+            if( mask != 0 )
+            {
+                return offset + http_server_scan_first_match( mask );
+            }
+            offset += 16;
+        }
+    }
+#elif defined( HTTP_SERVER_SCAN_USE_MVE )
+    while( ( length - offset ) >= 16 )
+    {
+        uint8x16_t   chunk = vld1q_u8( (const uint8_t*)( buffer + offset ) );
+        mve_pred16_t match = (mve_pred16_t)( vcmpeqq_n_u8( chunk, (uint8_t)d0 ) | vcmpeqq_n_u8( chunk, (uint8_t)d1 ) |
+                                             vcmpeqq_n_u8( chunk, (uint8_t)d2 ) | vcmpeqq_n_u8( chunk, (uint8_t)d3 ) );
+
+        if( match != 0 )
+        {
+            break;
+        }
+        offset += 16;
+    }
+#elif defined( HTTP_SERVER_SCAN_USE_NEON )
+    {
+        const uint8x16_t v0 = vdupq_n_u8( (uint8_t)d0 );
+        const uint8x16_t v1 = vdupq_n_u8( (uint8_t)d1 );
+        const uint8x16_t v2 = vdupq_n_u8( (uint8_t)d2 );
+        const uint8x16_t v3 = vdupq_n_u8( (uint8_t)d3 );
+
+        while( ( length - offset ) >= 16 )
+        {
+            uint8x16_t chunk = vld1q_u8( (const uint8_t*)( buffer + offset ) );
+            uint8x16_t match = vorrq_u8( vorrq_u8( vceqq_u8( chunk, v0 ), vceqq_u8( chunk, v1 ) ),
+                                         vorrq_u8( vceqq_u8( chunk, v2 ), vceqq_u8( chunk, v3 ) ) );
+            uint8x8_t  fold  = vorr_u8( vget_low_u8( match ), vget_high_u8( match ) );
+
+            if( vget_lane_u64( vreinterpret_u64_u8( fold ), 0 ) != 0 )
+            {
+                break;
+            }
+            offset += 16;
+        }
+    }
+#else
+    {
+        /* SWAR: a byte of ( word ^ pattern ) is zero exactly where the word holds the delimiter */
+        const uint64_t ones  = 0x0101010101010101ULL;
+        const uint64_t highs = 0x8080808080808080ULL;
+        const uint64_t p0    = ones * (uint8_t)d0;
+        const uint64_t p1    = ones * (uint8_t)d1;
+        const uint64_t p2    = ones * (uint8_t)d2;
+        const uint64_t p3    = ones * (uint8_t)d3;
+
+        while( ( length - offset ) >= sizeof( uint64_t ) )
+        {
+            uint64_t word;
+            uint64_t x0, x1, x2, x3;
+
+            memcpy( &word, buffer + offset, sizeof( word ) );
+            x0 = word ^ p0;
+            x1 = word ^ p1;
+            x2 = word ^ p2;
+            x3 = word ^ p3;
+
+            if( ( ( ( x0 - ones ) & ~x0 ) | ( ( x1 - ones ) & ~x1 ) | ( ( x2 - ones ) & ~x2 ) | ( ( x3 - ones ) & ~x3 ) ) & highs )
+            {
+                break;
+            }
+            offset += (uint32_t)sizeof( uint64_t );
+        }
+    }
+#endif
+
+    while( offset < length )
+    {
+        char c = buffer[ offset ];
+
+        if( ( c == d0 ) || ( c == d1 ) || ( c == d2 ) || ( c == d3 ) )
+        {
+            break;
+        }
+        offset++;
+    }
+
+    return offset;
+}
+
+/* Returns the value of a hexadecimal digit, or -1 if the character is not one */
+static int http_server_hex_digit_value( char c )
+{
+    if( c >= '0' && c <= '9' )
+    {
+        return c - '0';
+    }
+    else if( c >= 'a' && c <= 'f' )
+    {
+        return c - 'a' + 10;
+    }
+    else if( c >= 'A' && c <= 'F' )
+    {
+        return c - 'A' + 10;
+    }
+
+    return -1;
 }
 
 cy_rslt_t cy_http_server_response_stream_write_header( cy_http_response_stream_t *stream, cy_http_status_codes_t status_code, uint32_t content_length, cy_http_cache_t cache_type, cy_http_mime_type_t mime_type )
@@ -1195,6 +2238,12 @@ cy_rslt_t cy_http_server_response_stream_write_payload( cy_http_response_stream_
     cy_rtos_get_mutex( &stream->mutex, CY_RTOS_NEVER_TIMEOUT );
     hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "\ncy_http_server_response_stream_write_payload- Acquired Mutex %p ", stream->mutex );
 
+    /* The payload of a response to a HEAD request is dropped */
+    if( stream->omit_payload == true )
+    {
+        goto exit;
+    }
+
     if( stream->chunked_transfer_enabled == true )
     {
         char data_length_string[10];
@@ -1374,6 +2423,7 @@ static cy_rslt_t http_response_stream_init( cy_http_response_stream_t *stream, v
 
     memset( &(stream->tcp_stream), 0, sizeof( cy_tcp_stream_t ) );
     stream->chunked_transfer_enabled = false;
+    stream->omit_payload             = false;
     result = cy_tcp_stream_init( &stream->tcp_stream, socket );
     if( result != CY_RSLT_SUCCESS )
     {
@@ -1413,7 +2463,8 @@ cy_rslt_t http_response_stream_deinit( cy_http_response_stream_t *stream )
 
 cy_rslt_t cy_http_server_get_query_parameter_value( const char *url_query, const char *parameter_key, char **parameter_value, uint32_t *value_length )
 {
-    char* iterator = (char*)url_query;
+    char*    iterator = (char*)url_query;
+    char*    end_of_query;
 
     if( url_query == NULL || parameter_key == NULL ||
         parameter_value == NULL || value_length == NULL)
@@ -1422,15 +2473,14 @@ cy_rslt_t cy_http_server_get_query_parameter_value( const char *url_query, const
         return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
     }
 
+    end_of_query = iterator + strlen( url_query );
+
     while( *iterator != '\0' )
     {
         char*    current_key = iterator;
         uint32_t current_key_length;
 
-        while( ( *iterator != '\0' ) && ( *iterator != '=' ) && ( *iterator != '&' ) )
-        {
-            iterator++;
-        }
+        iterator += http_server_find_delimiter( iterator, (uint32_t)( end_of_query - iterator ), '=', '&', '=', '&' );
 
         current_key_length = (uint32_t)( iterator - current_key );
 
@@ -1439,10 +2489,7 @@ cy_rslt_t cy_http_server_get_query_parameter_value( const char *url_query, const
             if( *iterator == '=' )
             {
                 *parameter_value = iterator + 1;
-                while( *iterator != '\0' && *iterator != '&' )
-                {
-                    iterator++;
-                }
+                iterator += http_server_find_delimiter( iterator, (uint32_t)( end_of_query - iterator ), '&', '&', '&', '&' );
                 *value_length = (uint32_t)( iterator - *parameter_value );
             }
             else
@@ -1468,6 +2515,9 @@ cy_rslt_t cy_http_server_get_query_parameter_count( const char *url_query, uint3
 {
     char*    current_query = (char*) url_query;
     uint32_t param_count = 0;
+    uint32_t remaining_length;
+    uint32_t offset;
+
     if( current_query == NULL )
     {
         *count = param_count;
@@ -1476,16 +2526,14 @@ cy_rslt_t cy_http_server_get_query_parameter_count( const char *url_query, uint3
 
     /* Non-NULL URL query is considered 1 parameter */
     param_count = 1;
+    remaining_length = (uint32_t) strlen( current_query );
 
-    while( *current_query != '\0' )
+    /* Count up everytime '&' is found */
+    while( ( offset = http_server_find_delimiter( current_query, remaining_length, '&', '&', '&', '&' ) ) != remaining_length )
     {
-        /* Count up everytime '&' is found */
-        if( *current_query == '&' )
-        {
-            param_count++;
-        }
-
-        current_query++;
+        param_count++;
+        current_query    += offset + 1;
+        remaining_length -= offset + 1;
     }
 
     *count = param_count;
@@ -1509,609 +2557,3509 @@ cy_rslt_t cy_http_server_match_query_parameter( const char *url_query, const cha
     return result;
 }
 
-static void http_server_connect_callback( void *socket )
+cy_rslt_t cy_http_server_form_decoder_init( cy_http_form_decoder_t *decoder, cy_http_form_field_callback_t callback, void *arg )
 {
-    server_event_message_t message;
-    cy_rslt_t result = CY_RSLT_SUCCESS;
-
-    message.event_type = CY_SERVER_CONNECT_EVENT;
-    message.socket = socket;
-
-    hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "\n http_server_connect_callback received for socket : %p...\n",message.socket );
-    hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "\n Pushing to connect_event_queue...... \n" );
-    result = cy_rtos_put_queue(&connect_event_queue, &message, 0, 0);
-    if( result != CY_RSLT_SUCCESS )
+    if( decoder == NULL || callback == NULL )
     {
-        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "failure in pushing to queue : %d \n", (int) result );
-        return;
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nInvalid parameter to cy_http_server_form_decoder_init" );
+        return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
     }
 
-    return;
+    memset( decoder, 0x00, sizeof( cy_http_form_decoder_t ) );
+    decoder->callback = callback;
+    decoder->arg      = arg;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/* Appends decoded bytes to the field name or to the value buffer, passing the value on whenever the buffer fills up */
+static cy_rslt_t http_server_form_decoder_append( cy_http_form_decoder_t *decoder, const char *data, uint32_t length )
+{
+    uint32_t copy_length;
+
+    if( decoder->in_value == false )
+    {
+        if( length > ( HTTP_SERVER_FORM_MAX_KEY_LENGTH - decoder->key_length ) )
+        {
+            hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nForm field name exceeds %d bytes", HTTP_SERVER_FORM_MAX_KEY_LENGTH );
+            return CY_RSLT_ERROR;
+        }
+        memcpy( decoder->key + decoder->key_length, data, length );
+        decoder->key_length += length;
+        return CY_RSLT_SUCCESS;
+    }
+
+    while( length > 0 )
+    {
+        if( decoder->value_length == HTTP_SERVER_FORM_VALUE_BUFFER_SIZE )
+        {
+            decoder->callback( decoder->arg, decoder->key, decoder->key_length, decoder->value, decoder->value_length, false );
+            decoder->value_length = 0;
+        }
+
+        copy_length = HTTP_SERVER_FORM_VALUE_BUFFER_SIZE - decoder->value_length;
+        if( copy_length > length )
+        {
+            copy_length = length;
+        }
+        memcpy( decoder->value + decoder->value_length, data, copy_length );
+        decoder->value_length += copy_length;
+        data   += copy_length;
+        length -= copy_length;
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_http_server_form_decoder_process( cy_http_form_decoder_t *decoder, const uint8_t *data, uint32_t length )
+{
+    const char* input  = (const char*) data;
+    uint32_t    offset = 0;
+    uint32_t    run_length;
+    int         nibble;
+    char        c;
+
+    if( decoder == NULL || ( data == NULL && length != 0 ) )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nInvalid parameter to cy_http_server_form_decoder_process" );
+        return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
+    }
+
+    if( decoder->failed == true )
+    {
+        return CY_RSLT_ERROR;
+    }
+
+    while( offset < length )
+    {
+        /* Complete a "%XX" escape, which may have been split across fragments */
+        if( decoder->escape_length != 0 )
+        {
+            nibble = http_server_hex_digit_value( input[ offset++ ] );
+            if( nibble < 0 )
+            {
+                goto malformed;
+            }
+
+            if( decoder->escape_length == 1 )
+            {
+                decoder->escape_value  = (uint8_t) nibble;
+                decoder->escape_length = 2;
+            }
+            else
+            {
+                c = (char)( ( decoder->escape_value << 4 ) | nibble );
+                decoder->escape_length = 0;
+                if( http_server_form_decoder_append( decoder, &c, 1 ) != CY_RSLT_SUCCESS )
+                {
+                    goto malformed;
+                }
+            }
+            continue;
+        }
+
+        /* Copy the run of characters up to the next special character in one step; '=' is an ordinary character within a value */
+        if( decoder->in_value == false )
+        {
+            run_length = http_server_find_delimiter( input + offset, length - offset, '&', '=', '%', '+' );
+        }
+        else
+        {
+            run_length = http_server_find_delimiter( input + offset, length - offset, '&', '%', '+', '&' );
+        }
+
+        if( http_server_form_decoder_append( decoder, input + offset, run_length ) != CY_RSLT_SUCCESS )
+        {
+            goto malformed;
+        }
+        offset += run_length;
+        if( offset == length )
+        {
+            break;
+        }
+
+        c = input[ offset++ ];
+        switch( c )
+        {
+            case '=':
+                decoder->in_value = true;
+                break;
+
+            case '&':
+                /* Empty fields, as in "a=1&&b=2", are skipped */
+                if( ( decoder->in_value == true ) || ( decoder->key_length != 0 ) )
+                {
+                    decoder->callback( decoder->arg, decoder->key, decoder->key_length, decoder->value, decoder->value_length, true );
+                }
+                decoder->key_length   = 0;
+                decoder->value_length = 0;
+                decoder->in_value     = false;
+                break;
+
+            case '+':
+                if( http_server_form_decoder_append( decoder, " ", 1 ) != CY_RSLT_SUCCESS )
+                {
+                    goto malformed;
+                }
+                break;
+
+            default: /* '%' */
+                decoder->escape_length = 1;
+                break;
+        }
+    }
+
+    /* Pass on what has been decoded of the current value, so nothing but the field name is kept across fragments */
+    if( ( decoder->in_value == true ) && ( decoder->value_length != 0 ) )
+    {
+        decoder->callback( decoder->arg, decoder->key, decoder->key_length, decoder->value, decoder->value_length, false );
+        decoder->value_length = 0;
+    }
+
+    return CY_RSLT_SUCCESS;
+
+malformed:
+    hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : Malformed form body\r\n", __FUNCTION__ );
+    decoder->failed = true;
+    return CY_RSLT_ERROR;
+}
+
+cy_rslt_t cy_http_server_form_decoder_finish( cy_http_form_decoder_t *decoder )
+{
+    if( decoder == NULL )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nInvalid parameter to cy_http_server_form_decoder_finish" );
+        return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
+    }
+
+    if( ( decoder->failed == true ) || ( decoder->escape_length != 0 ) )
+    {
+        decoder->failed = true;
+        return CY_RSLT_ERROR;
+    }
+
+    if( ( decoder->in_value == true ) || ( decoder->key_length != 0 ) )
+    {
+        decoder->callback( decoder->arg, decoder->key, decoder->key_length, decoder->value, decoder->value_length, true );
+    }
+    decoder->key_length   = 0;
+    decoder->value_length = 0;
+    decoder->in_value     = false;
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_http_server_form_decoder_process_body( cy_http_form_decoder_t *decoder, const cy_http_message_body_t *http_data )
+{
+    cy_rslt_t result;
+
+    if( decoder == NULL || http_data == NULL )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nInvalid parameter to cy_http_server_form_decoder_process_body" );
+        return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
+    }
+
+    if( http_data->data != NULL )
+    {
+        result = cy_http_server_form_decoder_process( decoder, http_data->data, http_data->data_length );
+        if( result != CY_RSLT_SUCCESS )
+        {
+            return result;
+        }
+    }
+
+    if( http_data->end_of_body == true )
+    {
+        return cy_http_server_form_decoder_finish( decoder );
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_http_server_get_multipart_boundary( cy_http_response_stream_t *stream, char **boundary, uint32_t *boundary_length )
+{
+    char*    content_type;
+    uint32_t content_type_length;
+    uint32_t offset;
+    uint32_t start;
+
+    if( boundary == NULL || boundary_length == NULL )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nInvalid parameter to cy_http_server_get_multipart_boundary" );
+        return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
+    }
+
+    *boundary        = NULL;
+    *boundary_length = 0;
+
+    if( cy_http_server_get_request_header( stream, HTTP_CONTENT_TYPE_NAME, &content_type, &content_type_length ) != CY_RSLT_SUCCESS )
+    {
+        return CY_RSLT_HTTP_SERVER_ERROR_NOT_FOUND;
+    }
+
+    /* Look for a "boundary" parameter among the ';' separated media type parameters */
+    offset = http_server_find_delimiter( content_type, content_type_length, ';', ';', ';', ';' );
+    while( offset < content_type_length )
+    {
+        offset++;
+        while( ( offset < content_type_length ) && ( ( content_type[ offset ] == ' ' ) || ( content_type[ offset ] == '\t' ) ) )
+        {
+            offset++;
+        }
+
+        if( ( ( content_type_length - offset ) > ( sizeof( HTTP_MULTIPART_BOUNDARY_PARAMETER ) - 1 ) ) &&
+            ( http_server_token_equals( content_type + offset, sizeof( HTTP_MULTIPART_BOUNDARY_PARAMETER ) - 1,
+                                        HTTP_MULTIPART_BOUNDARY_PARAMETER, sizeof( HTTP_MULTIPART_BOUNDARY_PARAMETER ) - 1 ) == true ) )
+        {
+            offset += sizeof( HTTP_MULTIPART_BOUNDARY_PARAMETER ) - 1;
+            if( content_type[ offset ] == '"' )
+            {
+                start  = ++offset;
+                offset += http_server_find_delimiter( content_type + offset, content_type_length - offset, '"', '"', '"', '"' );
+                if( offset == content_type_length )
+                {
+                    return CY_RSLT_HTTP_SERVER_ERROR_NOT_FOUND;
+                }
+            }
+            else
+            {
+                start  = offset;
+                offset += http_server_find_delimiter( content_type + offset, content_type_length - offset, ';', ' ', '\t', ';' );
+            }
+
+            if( offset == start )
+            {
+                return CY_RSLT_HTTP_SERVER_ERROR_NOT_FOUND;
+            }
+
+            *boundary        = content_type + start;
+            *boundary_length = offset - start;
+            return CY_RSLT_SUCCESS;
+        }
+
+        offset += http_server_find_delimiter( content_type + offset, content_type_length - offset, ';', ';', ';', ';' );
+    }
+
+    return CY_RSLT_HTTP_SERVER_ERROR_NOT_FOUND;
+}
+
+cy_rslt_t cy_http_server_multipart_parser_init( cy_http_multipart_parser_t *parser, const char *boundary, uint32_t boundary_length,
+                                                cy_http_multipart_header_callback_t header_callback, cy_http_multipart_data_callback_t data_callback, void *arg )
+{
+    uint32_t i;
+
+    if( parser == NULL || boundary == NULL || boundary_length == 0 ||
+        boundary_length > HTTP_SERVER_MULTIPART_MAX_BOUNDARY_LENGTH || data_callback == NULL )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nInvalid parameter to cy_http_server_multipart_parser_init" );
+        return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
+    }
+
+    memset( parser, 0x00, sizeof( cy_http_multipart_parser_t ) );
+    parser->header_callback = header_callback;
+    parser->data_callback   = data_callback;
+    parser->arg             = arg;
+
+    /* Every boundary after the first is preceded by CRLF, which belongs to the boundary and not to the part data */
+    memcpy( parser->delimiter, HTTP_MULTIPART_DELIMITER_PREFIX, sizeof( HTTP_MULTIPART_DELIMITER_PREFIX ) - 1 );
+    memcpy( parser->delimiter + sizeof( HTTP_MULTIPART_DELIMITER_PREFIX ) - 1, boundary, boundary_length );
+    parser->delimiter_length = boundary_length + sizeof( HTTP_MULTIPART_DELIMITER_PREFIX ) - 1;
+
+    /* Boyer-Moore-Horspool bad character shifts */
+    memset( parser->skip, (int) parser->delimiter_length, sizeof( parser->skip ) );
+    for ( i = 0; i < ( parser->delimiter_length - 1 ); i++ )
+    {
+        parser->skip[ parser->delimiter[i] ] = (uint8_t)( parser->delimiter_length - 1 - i );
+    }
+
+    /* The first boundary may start the body, so behave as if the body was preceded by CRLF */
+    memcpy( parser->lookbehind, CRLF, sizeof( CRLF ) - 1 );
+    parser->lookbehind_length = sizeof( CRLF ) - 1;
+    parser->state = CY_HTTP_MULTIPART_PREAMBLE;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*
+ * Searches data for the delimiter. Returns true and its offset if it is found. Otherwise returns false and the offset from which
+ * the rest of the data is a prefix of the delimiter, or length if there is no such offset.
+ */
+static bool http_server_multipart_search( const cy_http_multipart_parser_t *parser, const uint8_t *data, uint32_t length, uint32_t *position )
+{
+    uint32_t last     = parser->delimiter_length - 1;
+    uint32_t offset   = 0;
+    uint8_t  c;
+
+    while( ( length - offset ) > last )
+    {
+        c = data[ offset + last ];
+        if( ( c == parser->delimiter[ last ] ) && ( memcmp( data + offset, parser->delimiter, last ) == COMPARE_MATCH ) )
+        {
+            *position = offset;
+            return true;
+        }
+        offset += parser->skip[ c ];
+    }
+
+    /* The shifts above never skip the start of a partial match, so only the remaining offsets need to be checked */
+    while( offset < length )
+    {
+        offset += http_server_find_delimiter( (const char*) data + offset, length - offset, '\r', '\r', '\r', '\r' );
+        if( ( offset == length ) || ( memcmp( data + offset, parser->delimiter, length - offset ) == COMPARE_MATCH ) )
+        {
+            break;
+        }
+        offset++;
+    }
+
+    *position = offset;
+    return false;
+}
+
+static void http_server_multipart_delimiter_found( cy_http_multipart_parser_t *parser )
+{
+    if( parser->state == CY_HTTP_MULTIPART_DATA )
+    {
+        parser->data_callback( parser->arg, NULL, 0, true );
+    }
+    parser->lookbehind_length = 0;
+    parser->state = CY_HTTP_MULTIPART_AFTER_BOUNDARY;
+}
+
+/*
+ * Consumes preamble or part data up to and including the next delimiter. Part data is passed to the application as it is found;
+ * bytes that may be the start of a delimiter are held back in the lookbehind buffer. Returns the number of bytes consumed.
+ */
+static uint32_t http_server_multipart_scan_data( cy_http_multipart_parser_t *parser, const uint8_t *data, uint32_t length )
+{
+    bool     emit = ( parser->state == CY_HTTP_MULTIPART_DATA );
+    uint32_t held;
+    uint32_t needed;
+    uint32_t compare_length;
+    uint32_t position;
+    uint32_t i;
+
+    /* Resume a delimiter that may have started in an earlier fragment */
+    for ( i = 0; i < parser->lookbehind_length; i++ )
+    {
+        held   = parser->lookbehind_length - i;
+        needed = parser->delimiter_length - held;
+        compare_length = ( length < needed ) ? length : needed;
+
+        if( ( memcmp( parser->lookbehind + i, parser->delimiter, held ) != COMPARE_MATCH ) ||
+            ( memcmp( data, parser->delimiter + held, compare_length ) != COMPARE_MATCH ) )
+        {
+            continue;
+        }
+
+        if( ( emit == true ) && ( i > 0 ) )
+        {
+            parser->data_callback( parser->arg, parser->lookbehind, i, false );
+        }
+
+        if( compare_length == needed )
+        {
+            http_server_multipart_delimiter_found( parser );
+            return needed;
+        }
+
+        /* Still a partial match; it is shorter than the delimiter, so it fits in the lookbehind buffer */
+        memmove( parser->lookbehind, parser->lookbehind + i, held );
+        memcpy( parser->lookbehind + held, data, length );
+        parser->lookbehind_length = held + length;
+        return length;
+    }
+
+    if( ( emit == true ) && ( parser->lookbehind_length > 0 ) )
+    {
+        parser->data_callback( parser->arg, parser->lookbehind, parser->lookbehind_length, false );
+    }
+    parser->lookbehind_length = 0;
+
+    if( http_server_multipart_search( parser, data, length, &position ) == true )
+    {
+        if( ( emit == true ) && ( position > 0 ) )
+        {
+            parser->data_callback( parser->arg, data, position, false );
+        }
+        http_server_multipart_delimiter_found( parser );
+        return position + parser->delimiter_length;
+    }
+
+    if( ( emit == true ) && ( position > 0 ) )
+    {
+        parser->data_callback( parser->arg, data, position, false );
+    }
+    memcpy( parser->lookbehind, data + position, length - position );
+    parser->lookbehind_length = length - position;
+
+    return length;
+}
+
+static bool http_server_multipart_process_header_line( cy_http_multipart_parser_t *parser )
+{
+    char*    line  = parser->header_line;
+    uint32_t length = parser->header_line_length;
+    uint32_t name_length;
+    uint32_t value_start;
+
+    if( ( length > 0 ) && ( line[ length - 1 ] == '\r' ) )
+    {
+        length--;
+    }
+
+    /* An empty line ends the part headers */
+    if( length == 0 )
+    {
+        parser->lookbehind_length = 0;
+        parser->state = CY_HTTP_MULTIPART_DATA;
+        return true;
+    }
+
+    name_length = http_server_find_delimiter( line, length, ':', ':', ':', ':' );
+    if( ( name_length == 0 ) || ( name_length == length ) )
+    {
+        return false;
+    }
+
+    value_start = name_length + 1;
+    while( ( value_start < length ) && ( ( line[ value_start ] == ' ' ) || ( line[ value_start ] == '\t' ) ) )
+    {
+        value_start++;
+    }
+    while( ( length > value_start ) && ( ( line[ length - 1 ] == ' ' ) || ( line[ length - 1 ] == '\t' ) ) )
+    {
+        length--;
+    }
+
+    if( parser->header_callback != NULL )
+    {
+        parser->header_callback( parser->arg, line, name_length, line + value_start, length - value_start );
+    }
+
+    return true;
+}
+
+cy_rslt_t cy_http_server_multipart_parser_process( cy_http_multipart_parser_t *parser, const uint8_t *data, uint32_t length )
+{
+    uint32_t offset = 0;
+    uint32_t run_length;
+    uint8_t  c;
+
+    if( parser == NULL || ( data == NULL && length != 0 ) )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nInvalid parameter to cy_http_server_multipart_parser_process" );
+        return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
+    }
+
+    while( ( offset < length ) && ( parser->state != CY_HTTP_MULTIPART_ERROR ) )
+    {
+        switch( parser->state )
+        {
+            case CY_HTTP_MULTIPART_PREAMBLE:
+            case CY_HTTP_MULTIPART_DATA:
+                offset += http_server_multipart_scan_data( parser, data + offset, length - offset );
+                break;
+
+            case CY_HTTP_MULTIPART_AFTER_BOUNDARY:
+                /* A boundary is followed by "--" if it is the last one, or else by optional whitespace and CRLF */
+                c = data[ offset++ ];
+                if( c == '-' )
+                {
+                    parser->state = CY_HTTP_MULTIPART_AFTER_BOUNDARY_DASH;
+                }
+                else if( c == '\r' )
+                {
+                    parser->state = CY_HTTP_MULTIPART_AFTER_BOUNDARY_CR;
+                }
+                else if( ( c != ' ' ) && ( c != '\t' ) )
+                {
+                    parser->state = CY_HTTP_MULTIPART_ERROR;
+                }
+                break;
+
+            case CY_HTTP_MULTIPART_AFTER_BOUNDARY_DASH:
+                parser->state = ( data[ offset++ ] == '-' ) ? CY_HTTP_MULTIPART_EPILOGUE : CY_HTTP_MULTIPART_ERROR;
+                break;
+
+            case CY_HTTP_MULTIPART_AFTER_BOUNDARY_CR:
+                parser->state = ( data[ offset++ ] == '\n' ) ? CY_HTTP_MULTIPART_HEADERS : CY_HTTP_MULTIPART_ERROR;
+                parser->header_line_length = 0;
+                break;
+
+            case CY_HTTP_MULTIPART_HEADERS:
+                run_length = http_server_find_delimiter( (const char*) data + offset, length - offset, '\n', '\n', '\n', '\n' );
+                if( run_length > ( HTTP_SERVER_MULTIPART_MAX_HEADER_LENGTH - parser->header_line_length ) )
+                {
+                    hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nMultipart header line exceeds %d bytes", HTTP_SERVER_MULTIPART_MAX_HEADER_LENGTH );
+                    parser->state = CY_HTTP_MULTIPART_ERROR;
+                    break;
+                }
+                memcpy( parser->header_line + parser->header_line_length, data + offset, run_length );
+                parser->header_line_length += run_length;
+                offset += run_length;
+
+                if( offset < length )
+                {
+                    offset++;
+                    if( http_server_multipart_process_header_line( parser ) == false )
+                    {
+                        parser->state = CY_HTTP_MULTIPART_ERROR;
+                    }
+                    parser->header_line_length = 0;
+                }
+                break;
+
+            case CY_HTTP_MULTIPART_EPILOGUE:
+                /* Anything after the last boundary is ignored */
+                offset = length;
+                break;
+
+            default:
+                parser->state = CY_HTTP_MULTIPART_ERROR;
+                break;
+        }
+    }
+
+    if( parser->state == CY_HTTP_MULTIPART_ERROR )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : Malformed multipart body\r\n", __FUNCTION__ );
+        return CY_RSLT_ERROR;
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_http_server_multipart_parser_finish( cy_http_multipart_parser_t *parser )
+{
+    if( parser == NULL )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nInvalid parameter to cy_http_server_multipart_parser_finish" );
+        return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
+    }
+
+    if( parser->state != CY_HTTP_MULTIPART_EPILOGUE )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : Multipart body ended before the closing boundary\r\n", __FUNCTION__ );
+        parser->state = CY_HTTP_MULTIPART_ERROR;
+        return CY_RSLT_ERROR;
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_http_server_multipart_parser_process_body( cy_http_multipart_parser_t *parser, const cy_http_message_body_t *http_data )
+{
+    cy_rslt_t result;
+
+    if( parser == NULL || http_data == NULL )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nInvalid parameter to cy_http_server_multipart_parser_process_body" );
+        return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
+    }
+
+    if( http_data->data != NULL )
+    {
+        result = cy_http_server_multipart_parser_process( parser, http_data->data, http_data->data_length );
+        if( result != CY_RSLT_SUCCESS )
+        {
+            return result;
+        }
+    }
+
+    if( http_data->end_of_body == true )
+    {
+        return cy_http_server_multipart_parser_finish( parser );
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/* Case-sensitive FNV-1a hash, for query keys and URLs */
+static uint32_t http_server_string_hash( const char *string, uint32_t length )
+{
+    uint32_t hash = HTTP_HEADER_HASH_OFFSET_BASIS;
+    uint32_t i;
+
+    for ( i = 0; i < length; i++ )
+    {
+        hash ^= (uint8_t) string[i];
+        hash *= HTTP_HEADER_HASH_PRIME;
+    }
+
+    return hash;
+}
+
+/*
+ * Splits a query string that is still escaped on '&' and then on the first '=', and decodes each key and value in
+ * place. The decoded parameters are packed at the start of the query, still separated by '&' and '=', and terminated
+ * with a NUL. Returns false if a key or value is not validly escaped.
+ */
+static bool http_server_query_index_build( cy_http_query_index_t *index, char *query, uint32_t length )
+{
+    cy_http_query_entry_t* entry;
+    uint32_t               start = 0;
+    uint32_t               end;
+    uint32_t               key_length;
+    uint32_t               value_start;
+    uint32_t               written = 0;
+    uint32_t               key_offset;
+    uint32_t               value_offset = 0;
+    uint16_t               decoded_key_length;
+    uint16_t               decoded_value_length = 0;
+    bool                   has_value;
+
+    index->base          = query;
+    index->count         = 0;
+    index->indexed_count = 0;
+
+    if( query == NULL )
+    {
+        return true;
+    }
+
+    /* A non-NULL query is at least 1 parameter, even when empty. Decoding never lengthens a span, so it can be written
+     * over the query already split
+     */
+    do
+    {
+        end        = start + http_server_find_delimiter( query + start, length - start, '&', '&', '&', '&' );
+        key_length = http_server_find_delimiter( query + start, end - start, '=', '=', '=', '=' );
+
+        key_offset         = written;
+        decoded_key_length = http_server_remove_escaped_characters( query + written, (uint16_t) key_length, query + start, (uint16_t) key_length );
+        if( ( decoded_key_length == 0 ) && ( key_length != 0 ) )
+        {
+            return false;
+        }
+        written += decoded_key_length;
+
+        has_value = ( key_length != ( end - start ) );
+        if( has_value == true )
+        {
+            query[ written++ ]   = '=';
+            value_start          = start + key_length + 1;
+            value_offset         = written;
+            decoded_value_length = http_server_remove_escaped_characters( query + written, (uint16_t)( end - value_start ),
+                                                                          query + value_start, (uint16_t)( end - value_start ) );
+            if( ( decoded_value_length == 0 ) && ( end != value_start ) )
+            {
+                return false;
+            }
+            written += decoded_value_length;
+        }
+
+        if( index->indexed_count < HTTP_SERVER_MAX_QUERY_PARAMETERS )
+        {
+            entry = &index->entries[ index->indexed_count++ ];
+            entry->hash       = http_server_string_hash( query + key_offset, decoded_key_length );
+            entry->key_offset = key_offset;
+            entry->key_length = decoded_key_length;
+            entry->has_value  = has_value;
+            entry->value_offset = ( has_value == true ) ? value_offset : 0;
+            entry->value_length = ( has_value == true ) ? decoded_value_length : 0;
+        }
+
+        index->count++;
+        start = end + 1;
+        if( end < length )
+        {
+            query[ written++ ] = '&';
+        }
+    } while( end < length );
+
+    query[ written ] = '\x00';
+    return true;
+}
+
+static const cy_http_query_entry_t* http_server_query_index_find( const cy_http_query_index_t *index, const char *key, uint32_t length )
+{
+    const cy_http_query_entry_t* entry;
+    uint32_t                     hash = http_server_string_hash( key, length );
+    uint32_t                     i;
+
+    for ( i = 0; i < index->indexed_count; i++ )
+    {
+        entry = &index->entries[i];
+        if( ( entry->hash == hash ) && ( entry->key_length == length ) &&
+            ( memcmp( index->base + entry->key_offset, key, length ) == COMPARE_MATCH ) )
+        {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+cy_rslt_t cy_http_server_get_query_parameter_by_key( cy_http_response_stream_t *stream, const char *parameter_key, char **parameter_value, uint32_t *value_length )
+{
+    /* Response streams handed to URL handlers are always the first member of a cy_http_stream_t */
+    cy_http_stream_t*            http_stream = (cy_http_stream_t*) stream;
+    const cy_http_query_index_t* index;
+    const cy_http_query_entry_t* entry;
+
+    if( stream == NULL || parameter_key == NULL ||
+        parameter_value == NULL || value_length == NULL )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nInvalid parameter to cy_http_server_get_query_parameter_by_key" );
+        return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
+    }
+
+    *parameter_value = NULL;
+    *value_length    = 0;
+
+    index = &http_stream->request.query;
+    if( index->base == NULL )
+    {
+        return CY_RSLT_HTTP_SERVER_ERROR_NOT_FOUND;
+    }
+
+    entry = http_server_query_index_find( index, parameter_key, (uint32_t) strlen( parameter_key ) );
+    if( entry == NULL )
+    {
+        return CY_RSLT_HTTP_SERVER_ERROR_NOT_FOUND;
+    }
+
+    if( entry->has_value == true )
+    {
+        *parameter_value = (char*)( index->base + entry->value_offset );
+        *value_length    = entry->value_length;
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_http_server_get_query_parameter_by_position( cy_http_response_stream_t *stream, uint32_t position, char **parameter_key, uint32_t *key_length, char **parameter_value, uint32_t *value_length )
+{
+    /* Response streams handed to URL handlers are always the first member of a cy_http_stream_t */
+    cy_http_stream_t*            http_stream = (cy_http_stream_t*) stream;
+    const cy_http_query_index_t* index;
+    const cy_http_query_entry_t* entry;
+
+    if( stream == NULL || parameter_key == NULL || key_length == NULL ||
+        parameter_value == NULL || value_length == NULL )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nInvalid parameter to cy_http_server_get_query_parameter_by_position" );
+        return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
+    }
+
+    *parameter_key   = NULL;
+    *key_length      = 0;
+    *parameter_value = NULL;
+    *value_length    = 0;
+
+    index = &http_stream->request.query;
+    if( ( index->base == NULL ) || ( position >= index->indexed_count ) )
+    {
+        return CY_RSLT_HTTP_SERVER_ERROR_NOT_FOUND;
+    }
+
+    entry = &index->entries[ position ];
+    *parameter_key = (char*)( index->base + entry->key_offset );
+    *key_length    = entry->key_length;
+    if( entry->has_value == true )
+    {
+        *parameter_value = (char*)( index->base + entry->value_offset );
+        *value_length    = entry->value_length;
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_http_server_get_query_parameter_count_by_stream( cy_http_response_stream_t *stream, uint32_t *count )
+{
+    /* Response streams handed to URL handlers are always the first member of a cy_http_stream_t */
+    cy_http_stream_t* http_stream = (cy_http_stream_t*) stream;
+
+    if( stream == NULL || count == NULL )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nInvalid parameter to cy_http_server_get_query_parameter_count_by_stream" );
+        return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
+    }
+
+    *count = http_stream->request.query.count;
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_http_server_get_path_parameters( cy_http_response_stream_t *stream, const cy_http_path_parameter_t **parameters, uint32_t *count )
+{
+    /* Response streams handed to URL handlers are always the first member of a cy_http_stream_t */
+    cy_http_stream_t* http_stream = (cy_http_stream_t*) stream;
+
+    if( stream == NULL || parameters == NULL || count == NULL )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nInvalid parameter to cy_http_server_get_path_parameters" );
+        return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
+    }
+
+    *parameters = http_stream->request.path_parameters;
+    *count      = http_stream->request.path_parameter_count;
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_http_server_get_path_parameter( cy_http_response_stream_t *stream, const char *name, const cy_http_path_parameter_t **parameter )
+{
+    /* Response streams handed to URL handlers are always the first member of a cy_http_stream_t */
+    cy_http_stream_t* http_stream = (cy_http_stream_t*) stream;
+    size_t            name_length;
+    uint8_t           i;
+
+    if( stream == NULL || name == NULL || parameter == NULL )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nInvalid parameter to cy_http_server_get_path_parameter" );
+        return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
+    }
+
+    *parameter  = NULL;
+    name_length = strlen( name );
+
+    for( i = 0; i < http_stream->request.path_parameter_count; i++ )
+    {
+        if( ( http_stream->request.path_parameters[ i ].name_length == name_length ) &&
+            ( memcmp( http_stream->request.path_parameters[ i ].name, name, name_length ) == COMPARE_MATCH ) )
+        {
+            *parameter = &http_stream->request.path_parameters[ i ];
+            return CY_RSLT_SUCCESS;
+        }
+    }
+
+    return CY_RSLT_HTTP_SERVER_ERROR_NOT_FOUND;
+}
+
+cy_rslt_t cy_http_server_get_request_header( cy_http_response_stream_t *stream, const char *header_name, char **header_value, uint32_t *value_length )
+{
+    /* Response streams handed to URL handlers are always the first member of a cy_http_stream_t */
+    cy_http_stream_t*             http_stream = (cy_http_stream_t*) stream;
+    const cy_http_header_index_t* index;
+    const cy_http_header_entry_t* entry;
+
+    if( stream == NULL || header_name == NULL ||
+        header_value == NULL || value_length == NULL )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nInvalid parameter to cy_http_server_get_request_header" );
+        return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
+    }
+
+    *header_value = NULL;
+    *value_length = 0;
+
+    index = &http_stream->request.parser.headers;
+    if( index->base == NULL )
+    {
+        return CY_RSLT_HTTP_SERVER_ERROR_NOT_FOUND;
+    }
+
+    entry = http_server_header_index_find( index, header_name, (uint32_t) strlen( header_name ) );
+    if( entry == NULL )
+    {
+        return CY_RSLT_HTTP_SERVER_ERROR_NOT_FOUND;
+    }
+
+    *header_value = (char*)( index->base + entry->value_offset );
+    *value_length = entry->value_length;
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_http_server_request_body_pause( cy_http_response_stream_t *stream )
+{
+    /* Response streams handed to URL handlers are always the first member of a cy_http_stream_t */
+    cy_http_stream_t* http_stream = (cy_http_stream_t*) stream;
+
+    if( stream == NULL )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nInvalid parameter to cy_http_server_request_body_pause" );
+        return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
+    }
+
+    http_stream->request.receive_paused = true;
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cy_http_server_request_body_resume( cy_http_response_stream_t *stream )
+{
+    cy_http_stream_t*      http_stream = (cy_http_stream_t*) stream;
+    server_event_message_t message;
+    cy_rslt_t              result;
+
+    if( stream == NULL || stream->tcp_stream.socket == NULL )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nInvalid parameter to cy_http_server_request_body_resume" );
+        return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
+    }
+
+    if( http_stream->request.receive_paused == false )
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    /* The stream is resumed by the event thread, which alone reads it; it stays paused if that cannot be asked */
+    message.event_type = CY_SERVER_RESUME_EVENT;
+    message.socket     = stream->tcp_stream.socket;
+    result = cy_rtos_put_queue( &event_queue, &message, 0, 0 );
+    if( result != CY_RSLT_SUCCESS )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nFailure in pushing to queue : %d \n", (int) result );
+        return CY_RSLT_ERROR;
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+static void http_server_connect_callback( void *socket )
+{
+    server_event_message_t message;
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+
+    message.event_type = CY_SERVER_CONNECT_EVENT;
+    message.socket = socket;
+
+    hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "\n http_server_connect_callback received for socket : %p...\n",message.socket );
+    hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "\n Pushing to connect_event_queue...... \n" );
+    result = cy_rtos_put_queue(&connect_event_queue, &message, 0, 0);
+    if( result != CY_RSLT_SUCCESS )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "failure in pushing to queue : %d \n", (int) result );
+        return;
+    }
+
+    return;
 }
 
 void http_server_disconnect_callback( void *socket )
 {
-    server_event_message_t message;
-    cy_rslt_t result = CY_RSLT_SUCCESS;
+    server_event_message_t message;
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+
+    message.event_type = CY_SOCKET_DISCONNECT_EVENT;
+    message.socket = socket;
+
+    hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_INFO, "\nhttp_server_disconnect_callback received for socket : %p\n",message.socket );
+    hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG," \nPushing to event_queue...... \n" );
+    result = cy_rtos_put_queue( &event_queue, &message, 0, 0 );
+    if( result != CY_RSLT_SUCCESS )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nFailure in pushing to queue : %d \n", (int) result );
+        return;
+    }
+    return;
+}
+
+void http_server_receive_callback( void *socket )
+{
+    server_event_message_t message;
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+
+    message.event_type = CY_SOCKET_PACKET_RECEIVED_EVENT;
+    message.socket = socket;
+    hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG," \nhttp_server_receive_callback received for socket : %p...\n",message.socket );
+    hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG," \nPushing to event_queue...... \n" );
+    result = cy_rtos_put_queue( &event_queue, &message, 0, 0 );
+    if( result != CY_RSLT_SUCCESS )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nfailure in pushing to queue : %d \n", (int) result );
+        return;
+    }
+
+    return;
+}
+
+static uint32_t http_server_header_name_hash( const char *name, uint32_t length )
+{
+    uint32_t hash = HTTP_HEADER_HASH_OFFSET_BASIS;
+    uint32_t i;
+
+    for ( i = 0; i < length; i++ )
+    {
+        hash ^= (uint8_t) HTTP_TO_LOWER( name[i] );
+        hash *= HTTP_HEADER_HASH_PRIME;
+    }
+
+    return hash;
+}
+
+static bool http_server_header_name_equals( const char *name1, const char *name2, uint32_t length )
+{
+    uint32_t i;
+
+    for ( i = 0; i < length; i++ )
+    {
+        if( HTTP_TO_LOWER( name1[i] ) != HTTP_TO_LOWER( name2[i] ) )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void http_server_header_index_add( cy_http_header_index_t *index, uint32_t hash, uint32_t name_offset, uint32_t name_length, uint32_t value_offset, uint32_t value_length )
+{
+    cy_http_header_entry_t* entry;
+    uint32_t                bucket = hash % HTTP_HEADER_INDEX_BUCKETS;
+
+    if( index->count == HTTP_SERVER_MAX_REQUEST_HEADERS )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : Header index full, header not indexed\r\n", __FUNCTION__ );
+        return;
+    }
+
+    /* Linear probing; the table never fills up as it has twice as many buckets as entries */
+    while( index->buckets[ bucket ] != 0 )
+    {
+        bucket = ( bucket + 1 ) % HTTP_HEADER_INDEX_BUCKETS;
+    }
+
+    entry               = &index->entries[ index->count ];
+    entry->hash         = hash;
+    entry->name_offset  = name_offset;
+    entry->name_length  = name_length;
+    entry->value_offset = value_offset;
+    entry->value_length = value_length;
+
+    index->count++;
+    index->buckets[ bucket ] = index->count;
+}
+
+static const cy_http_header_entry_t* http_server_header_index_find( const cy_http_header_index_t *index, const char *name, uint32_t length )
+{
+    const cy_http_header_entry_t* entry;
+    uint32_t                      hash   = http_server_header_name_hash( name, length );
+    uint32_t                      bucket = hash % HTTP_HEADER_INDEX_BUCKETS;
+
+    while( index->buckets[ bucket ] != 0 )
+    {
+        entry = &index->entries[ index->buckets[ bucket ] - 1 ];
+        if( ( entry->hash == hash ) && ( entry->name_length == length ) &&
+            ( http_server_header_name_equals( index->base + entry->name_offset, name, length ) == true ) )
+        {
+            return entry;
+        }
+        bucket = ( bucket + 1 ) % HTTP_HEADER_INDEX_BUCKETS;
+    }
+
+    return NULL;
+}
+
+/*
+ * Decides whether a header is to be indexed and returns its hash if it is. The name length and the hash are first checked against
+ * bit masks, so most headers of no interest are rejected without comparing names, and often without hashing them.
+ */
+static bool http_server_header_is_of_interest( const cy_http_header_interest_t *interest, const char *name, uint32_t length, uint32_t *hash )
+{
+    uint32_t i;
+
+    if( ( interest == NULL ) || ( interest->count == 0 ) )
+    {
+        *hash = http_server_header_name_hash( name, length );
+        return true;
+    }
+
+    if( ( interest->length_mask & ( 1UL << ( ( length < 31 ) ? length : 31 ) ) ) == 0 )
+    {
+        return false;
+    }
+
+    *hash = http_server_header_name_hash( name, length );
+    if( ( interest->hash_mask & ( 1UL << ( *hash % 32 ) ) ) == 0 )
+    {
+        return false;
+    }
+
+    for ( i = 0; i < interest->count; i++ )
+    {
+        if( ( interest->hashes[i] == *hash ) && ( interest->name_lengths[i] == length ) &&
+            ( http_server_header_name_equals( interest->names[i], name, length ) == true ) )
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void http_server_parser_reset( cy_http_request_parser_t *parser, const cy_http_header_interest_t *interest )
+{
+    memset( parser, 0, offsetof( cy_http_request_parser_t, headers ) );
+    parser->interest      = interest;
+    parser->headers.base  = NULL;
+    parser->headers.count = 0;
+    memset( parser->headers.buckets, 0, sizeof( parser->headers.buckets ) );
+}
+
+static bool http_server_token_equals( const char *string, uint32_t length, const char *token, uint32_t token_length )
+{
+    uint32_t i;
+
+    if( length != token_length )
+    {
+        return false;
+    }
+
+    for ( i = 0; i < length; i++ )
+    {
+        if( HTTP_TO_LOWER( string[i] ) != token[i] )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static bool http_server_parser_process_header( cy_http_request_parser_t *parser, const char *buffer, uint32_t value_length )
+{
+    const char* name  = buffer + parser->line_start;
+    const char* value = buffer + parser->value_start;
+    uint32_t    hash;
+    uint32_t    i;
+
+    /* Strip trailing whitespace from the value */
+    while( ( value_length > 0 ) && ( ( value[ value_length - 1 ] == ' ' ) || ( value[ value_length - 1 ] == '\t' ) ) )
+    {
+        value_length--;
+    }
+
+    /* Only the headers the server itself depends on are interpreted here. Dispatch on the name length first so
+     * that most header lines are rejected without comparing any characters. */
+    switch( parser->name_length )
+    {
+        case sizeof( HTTP_CONTENT_TYPE_NAME ) - 1:
+            if( http_server_token_equals( name, parser->name_length, "content-type", sizeof( HTTP_CONTENT_TYPE_NAME ) - 1 ) )
+            {
+                parser->content_type_offset = parser->value_start;
+                parser->content_type_length = value_length;
+            }
+            break;
+
+        case sizeof( HTTP_CONTENT_LENGTH_NAME ) - 1:
+            if( http_server_token_equals( name, parser->name_length, "content-length", sizeof( HTTP_CONTENT_LENGTH_NAME ) - 1 ) )
+            {
+                uint32_t content_length = 0;
+
+                if( value_length == 0 )
+                {
+                    return false;
+                }
+
+                for ( i = 0; i < value_length; i++ )
+                {
+                    if( ( value[i] < '0' ) || ( value[i] > '9' ) || ( content_length > ( ( UINT32_MAX - 9 ) / 10 ) ) )
+                    {
+                        return false;
+                    }
+                    content_length = ( content_length * 10 ) + (uint32_t)( value[i] - '0' );
+                }
+
+                /* Differing lengths leave the end of the body, and so the start of the next request, ambiguous */
+                if( ( parser->has_content_length == true ) && ( parser->content_length != content_length ) )
+                {
+                    return false;
+                }
+
+                parser->content_length     = content_length;
+                parser->has_content_length = true;
+            }
+            break;
+
+        case sizeof( HTTP_TRANSFER_ENCODING_NAME ) - 1:
+            if( http_server_token_equals( name, parser->name_length, "transfer-encoding", sizeof( HTTP_TRANSFER_ENCODING_NAME ) - 1 ) )
+            {
+                uint32_t coding_start = 0;
+                uint32_t coding_end;
+
+                /* The value is a comma-separated list of codings, and chunked must be the final coding applied to the
+                 * body, which is checked once the header is complete. A list that is not well formed is not chunked. */
+                parser->has_transfer_encoding = true;
+                parser->is_chunked            = false;
+                for ( i = 0; i <= value_length; i++ )
+                {
+                    if( ( i < value_length ) && ( value[i] != ',' ) )
+                    {
+                        continue;
+                    }
+
+                    coding_end = i;
+                    while( ( coding_start < coding_end ) && ( ( value[ coding_start ] == ' ' ) || ( value[ coding_start ] == '\t' ) ) )
+                    {
+                        coding_start++;
+                    }
+                    while( ( coding_end > coding_start ) && ( ( value[ coding_end - 1 ] == ' ' ) || ( value[ coding_end - 1 ] == '\t' ) ) )
+                    {
+                        coding_end--;
+                    }
+                    if( ( coding_start == coding_end ) || ( memchr( value + coding_start, ' ', coding_end - coding_start ) != NULL ) ||
+                        ( memchr( value + coding_start, '\t', coding_end - coding_start ) != NULL ) )
+                    {
+                        parser->is_chunked = false;
+                        break;
+                    }
+
+                    parser->is_chunked = http_server_token_equals( value + coding_start, coding_end - coding_start, HTTP_CHUNKED_TOKEN, sizeof( HTTP_CHUNKED_TOKEN ) - 1 );
+                    coding_start       = i + 1;
+                }
+            }
+            break;
+
+        case sizeof( HTTP_CONNECTION_NAME ) - 1:
+            if( http_server_token_equals( name, parser->name_length, "connection", sizeof( HTTP_CONNECTION_NAME ) - 1 ) )
+            {
+                parser->connection_close = http_server_token_equals( value, value_length, HTTP_CLOSE_TOKEN, sizeof( HTTP_CLOSE_TOKEN ) - 1 );
+            }
+            break;
+
+        case sizeof( HTTP_EXPECT_NAME ) - 1:
+            if( http_server_token_equals( name, parser->name_length, "expect", sizeof( HTTP_EXPECT_NAME ) - 1 ) )
+            {
+                if( http_server_token_equals( value, value_length, HTTP_100_CONTINUE_TOKEN, sizeof( HTTP_100_CONTINUE_TOKEN ) - 1 ) )
+                {
+                    parser->expect_continue = true;
+                }
+                else
+                {
+                    parser->expect_unsupported = true;
+                }
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    if( http_server_header_is_of_interest( parser->interest, name, parser->name_length, &hash ) == true )
+    {
+        http_server_header_index_add( &parser->headers, hash, parser->line_start, parser->name_length, parser->value_start, value_length );
+    }
+
+    return true;
+}
+
+/*
+ * Runs the header parser over buffer[parser->offset .. length). The buffer must hold the request from its first byte;
+ * bytes scanned by a previous call are not looked at again. Parsing stops at the end of the header section, so any
+ * body bytes in the buffer are left untouched.
+ */
+static cy_http_parser_state_t http_server_parser_execute( cy_http_request_parser_t *parser, const char *buffer, uint32_t length )
+{
+    uint32_t offset = parser->offset;
+    char     c;
+
+    while( ( offset < length ) && ( parser->state < CY_HTTP_PARSER_COMPLETE ) )
+    {
+        /* Skip over the bulk of the request line, header names and header values in one scan */
+        if( ( parser->state == CY_HTTP_PARSER_REQUEST_LINE ) || ( parser->state == CY_HTTP_PARSER_HEADER_VALUE ) )
+        {
+            offset += http_server_find_delimiter( buffer + offset, length - offset, '\r', '\n', '\r', '\n' );
+        }
+        else if( parser->state == CY_HTTP_PARSER_HEADER_NAME )
+        {
+            offset += http_server_find_delimiter( buffer + offset, length - offset, ':', '\r', '\n', ':' );
+        }
+
+        if( offset == length )
+        {
+            break;
+        }
+
+        c = buffer[ offset ];
+
+        switch( parser->state )
+        {
+            case CY_HTTP_PARSER_REQUEST_LINE:
+                if( ( c == '\r' ) || ( c == '\n' ) )
+                {
+                    parser->request_line_length = offset;
+                    parser->state = ( c == '\r' ) ? CY_HTTP_PARSER_LINE_LF : CY_HTTP_PARSER_HEADER_START;
+                }
+                break;
+
+            case CY_HTTP_PARSER_LINE_LF:
+                parser->state = ( c == '\n' ) ? CY_HTTP_PARSER_HEADER_START : CY_HTTP_PARSER_ERROR;
+                break;
+
+            case CY_HTTP_PARSER_HEADER_START:
+                if( c == '\r' )
+                {
+                    parser->state = CY_HTTP_PARSER_HEADERS_END_LF;
+                }
+                else if( c == '\n' )
+                {
+                    parser->header_length = offset + 1;
+                    parser->state = CY_HTTP_PARSER_COMPLETE;
+                }
+                else if( ( c == ' ' ) || ( c == '\t' ) || ( c == ':' ) )
+                {
+                    /* Folded header lines and empty header names are not accepted */
+                    parser->state = CY_HTTP_PARSER_ERROR;
+                }
+                else
+                {
+                    parser->line_start = offset;
+                    parser->state = CY_HTTP_PARSER_HEADER_NAME;
+                }
+                break;
+
+            case CY_HTTP_PARSER_HEADER_NAME:
+                if( c == ':' )
+                {
+                    parser->name_length = offset - parser->line_start;
+                    parser->state = CY_HTTP_PARSER_HEADER_VALUE_START;
+                }
+                else if( ( c == '\r' ) || ( c == '\n' ) )
+                {
+                    parser->state = CY_HTTP_PARSER_ERROR;
+                }
+                break;
+
+            case CY_HTTP_PARSER_HEADER_VALUE_START:
+                if( ( c == ' ' ) || ( c == '\t' ) )
+                {
+                    break;
+                }
+                parser->value_start = offset;
+                parser->state = CY_HTTP_PARSER_HEADER_VALUE;
+                /* Fall through */
+            case CY_HTTP_PARSER_HEADER_VALUE:
+                if( ( c == '\r' ) || ( c == '\n' ) )
+                {
+                    if( http_server_parser_process_header( parser, buffer, offset - parser->value_start ) == false )
+                    {
+                        parser->state = CY_HTTP_PARSER_ERROR;
+                    }
+                    else
+                    {
+                        parser->state = ( c == '\r' ) ? CY_HTTP_PARSER_LINE_LF : CY_HTTP_PARSER_HEADER_START;
+                    }
+                }
+                break;
+
+            case CY_HTTP_PARSER_HEADERS_END_LF:
+                if( c == '\n' )
+                {
+                    parser->header_length = offset + 1;
+                    parser->state = CY_HTTP_PARSER_COMPLETE;
+                }
+                else
+                {
+                    parser->state = CY_HTTP_PARSER_ERROR;
+                }
+                break;
+
+            default:
+                parser->state = CY_HTTP_PARSER_ERROR;
+                break;
+        }
+
+        offset++;
+    }
+
+    parser->offset = offset;
+    return parser->state;
+}
+
+/*
+ * Removes the chunked transfer coding from the next part of a request body. The chunk data is moved to the start of the buffer
+ * and its length returned in decoded_length; chunk sizes, extensions and trailers are discarded. Decoding stops after the
+ * trailers of the last chunk; consumed tells how much of the input was used, so that any following request can be found.
+ */
+static cy_http_chunked_state_t http_server_chunked_decode( cy_http_chunked_decoder_t *decoder, uint8_t *data, uint32_t length, uint32_t *decoded_length, uint32_t *consumed )
+{
+    uint32_t offset = 0;
+    uint32_t output = 0;
+    uint32_t copy_length;
+    int      digit;
+    uint8_t  c;
+
+    while( ( offset < length ) && ( decoder->state != CY_HTTP_CHUNKED_DONE ) && ( decoder->state != CY_HTTP_CHUNKED_ERROR ) )
+    {
+        if( decoder->state == CY_HTTP_CHUNKED_DATA )
+        {
+            copy_length = length - offset;
+            if( copy_length > decoder->chunk_remaining )
+            {
+                copy_length = decoder->chunk_remaining;
+            }
+            if( output != offset )
+            {
+                memmove( data + output, data + offset, copy_length );
+            }
+            output += copy_length;
+            offset += copy_length;
+            decoder->chunk_remaining -= copy_length;
+            if( decoder->chunk_remaining == 0 )
+            {
+                decoder->state = CY_HTTP_CHUNKED_DATA_CR;
+            }
+            continue;
+        }
+
+        c = data[ offset++ ];
+
+        switch( decoder->state )
+        {
+            case CY_HTTP_CHUNKED_SIZE:
+                digit = http_server_hex_digit_value( (char) c );
+                if( digit >= 0 )
+                {
+                    if( decoder->chunk_remaining > ( UINT32_MAX >> 4 ) )
+                    {
+                        decoder->state = CY_HTTP_CHUNKED_ERROR;
+                        break;
+                    }
+                    decoder->chunk_remaining = ( decoder->chunk_remaining << 4 ) | (uint32_t) digit;
+                    decoder->has_size = true;
+                }
+                else if( decoder->has_size == false )
+                {
+                    decoder->state = CY_HTTP_CHUNKED_ERROR;
+                }
+                else if( c == '\r' )
+                {
+                    decoder->state = CY_HTTP_CHUNKED_SIZE_LF;
+                }
+                else if( c == '\n' )
+                {
+                    decoder->state = ( decoder->chunk_remaining == 0 ) ? CY_HTTP_CHUNKED_TRAILER_START : CY_HTTP_CHUNKED_DATA;
+                }
+                else if( ( c == ';' ) || ( c == ' ' ) || ( c == '\t' ) )
+                {
+                    decoder->state = CY_HTTP_CHUNKED_EXTENSION;
+                }
+                else
+                {
+                    decoder->state = CY_HTTP_CHUNKED_ERROR;
+                }
+                break;
+
+            case CY_HTTP_CHUNKED_EXTENSION:
+                /* Chunk extensions are not interpreted */
+                offset += http_server_find_delimiter( (const char*) data + offset, length - offset, '\r', '\n', '\r', '\n' );
+                if( c == '\r' )
+                {
+                    decoder->state = CY_HTTP_CHUNKED_SIZE_LF;
+                }
+                else if( c == '\n' )
+                {
+                    decoder->state = ( decoder->chunk_remaining == 0 ) ? CY_HTTP_CHUNKED_TRAILER_START : CY_HTTP_CHUNKED_DATA;
+                }
+                break;
+
+            case CY_HTTP_CHUNKED_SIZE_LF:
+                if( c == '\n' )
+                {
+                    decoder->state = ( decoder->chunk_remaining == 0 ) ? CY_HTTP_CHUNKED_TRAILER_START : CY_HTTP_CHUNKED_DATA;
+                }
+                else
+                {
+                    decoder->state = CY_HTTP_CHUNKED_ERROR;
+                }
+                break;
+
+            case CY_HTTP_CHUNKED_DATA_CR:
+                if( c == '\r' )
+                {
+                    decoder->state = CY_HTTP_CHUNKED_DATA_LF;
+                    break;
+                }
+                /* Fall through */
+            case CY_HTTP_CHUNKED_DATA_LF:
+                if( c == '\n' )
+                {
+                    decoder->state           = CY_HTTP_CHUNKED_SIZE;
+                    decoder->chunk_remaining = 0;
+                    decoder->has_size        = false;
+                }
+                else
+                {
+                    decoder->state = CY_HTTP_CHUNKED_ERROR;
+                }
+                break;
+
+            case CY_HTTP_CHUNKED_TRAILER_START:
+                if( c == '\r' )
+                {
+                    decoder->state = CY_HTTP_CHUNKED_TRAILER_END_LF;
+                }
+                else if( c == '\n' )
+                {
+                    decoder->state = CY_HTTP_CHUNKED_DONE;
+                }
+                else
+                {
+                    decoder->state = CY_HTTP_CHUNKED_TRAILER_LINE;
+                }
+                break;
+
+            case CY_HTTP_CHUNKED_TRAILER_LINE:
+                /* Trailer fields are not interpreted */
+                if( c == '\n' )
+                {
+                    decoder->state = CY_HTTP_CHUNKED_TRAILER_START;
+                }
+                else
+                {
+                    offset += http_server_find_delimiter( (const char*) data + offset, length - offset, '\n', '\n', '\n', '\n' );
+                }
+                break;
+
+            case CY_HTTP_CHUNKED_TRAILER_END_LF:
+                decoder->state = ( c == '\n' ) ? CY_HTTP_CHUNKED_DONE : CY_HTTP_CHUNKED_ERROR;
+                break;
+
+            default:
+                decoder->state = CY_HTTP_CHUNKED_ERROR;
+                break;
+        }
+    }
+
+    *decoded_length = output;
+    *consumed       = offset;
+    return decoder->state;
+}
+
+/* Returns true while more of the request body is expected after the current packet */
+static bool http_server_request_body_pending( const cy_http_stream_t *stream )
+{
+    return ( stream->request.data_remaining > 0 ) ||
+           ( ( stream->request.chunked.state != CY_HTTP_CHUNKED_NONE ) &&
+             ( stream->request.chunked.state != CY_HTTP_CHUNKED_DONE ) &&
+             ( stream->request.chunked.state != CY_HTTP_CHUNKED_ERROR ) );
+}
+
+/* Returns the reassembly buffer held by a stream, if any, to the free list */
+static void http_server_release_reassembly_buffer( cy_http_server_info_t *server, cy_http_stream_t *stream )
+{
+    if( stream->request.reassembly != NULL )
+    {
+        cy_linked_list_insert_node_at_rear( &server->free_reassembly_list, &stream->request.reassembly->node );
+        stream->request.reassembly = NULL;
+        http_server_account_memory( server, stream, 0 );
+    }
+}
+
+/* Records the number of bytes of an incomplete request header a stream now holds */
+static void http_server_account_memory( cy_http_server_info_t *server, cy_http_stream_t *stream, uint32_t held )
+{
+    cy_http_server_memory_usage_t* usage = &server->memory_usage;
+
+    usage->header_bytes = usage->header_bytes - stream->request.memory_held + held;
+    stream->request.memory_held = held;
+
+    if( held > usage->connection_peak )
+    {
+        usage->connection_peak = held;
+    }
+    if( usage->header_bytes > usage->header_bytes_peak )
+    {
+        usage->header_bytes_peak = usage->header_bytes;
+    }
+}
+
+/* Answers a request that does not fit in the memory budgets; the caller closes the connection */
+static void http_server_reject_request( cy_http_server_info_t *server, cy_http_stream_t *stream, cy_http_status_codes_t status_code )
+{
+    hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : Request rejected with status [%d]\r\n", __FUNCTION__, status_code );
+
+    if( status_code == CY_HTTP_431_TYPE )
+    {
+        server->memory_usage.connection_rejections++;
+    }
+    else
+    {
+        server->memory_usage.total_rejections++;
+    }
+
+    http_server_write_error_response( stream, status_code );
+}
+
+/* Answers a request that is not processed with a status alone */
+static void http_server_write_error_response( cy_http_stream_t *stream, cy_http_status_codes_t status_code )
+{
+    if( cy_http_server_response_stream_write_header( &stream->response, status_code, NO_CONTENT_LENGTH, CY_HTTP_CACHE_DISABLED, MIME_TYPE_TEXT_HTML ) == CY_RSLT_SUCCESS )
+    {
+        cy_http_server_response_stream_flush( &stream->response );
+    }
+}
+
+/*
+ * Returns where the next packet of a stream is to be received. A packet goes straight to the free space of a
+ * reassembly buffer, taken from the pool if the stream holds none, so that a split header needs no copy. The given
+ * fallback buffer is used only when the pool is empty.
+ */
+static char* http_server_get_receive_buffer( cy_http_server_info_t *server, cy_http_stream_t *stream, char *fallback, uint32_t *size )
+{
+    cy_http_reassembly_buffer_t* reassembly = stream->request.reassembly;
+    uint32_t                     receive_size = server->receive_size;
+
+    if( reassembly == NULL )
+    {
+        if( cy_linked_list_remove_node_from_front( &server->free_reassembly_list, (cy_linked_list_node_t**)&reassembly ) != CY_RSLT_SUCCESS )
+        {
+            *size = ( receive_size < HTTP_SERVER_MTU_SIZE ) ? receive_size : HTTP_SERVER_MTU_SIZE;
+            return fallback;
+        }
+        reassembly->length = 0;
+        stream->request.reassembly = reassembly;
+    }
+
+    *size = HTTP_SERVER_REASSEMBLY_BUFFER_SIZE - reassembly->length;
+    if( *size > receive_size )
+    {
+        *size = receive_size;
+    }
+    return reassembly->data + reassembly->length;
+}
+
+/* Returns the receive buffer of a stream to the pool, unless it holds part of a request header */
+static void http_server_put_receive_buffer( cy_http_server_info_t *server, cy_http_stream_t *stream )
+{
+    if( ( stream->request.reassembly != NULL ) && ( stream->request.reassembly->length == 0 ) )
+    {
+        http_server_release_reassembly_buffer( server, stream );
+    }
+}
+
+/* Drops the rest of the request body; the stream no longer expects continuation packets */
+static void http_server_request_body_abandon( cy_http_stream_t *stream )
+{
+    stream->request.data_remaining = 0;
+    stream->request.chunked.state  = CY_HTTP_CHUNKED_NONE;
+    stream->request.receive_paused = false;
+    stream->request.receive_drain  = false;
+}
+
+/*
+ * Passes the next part of a request body that did not fit in the packet holding the request to the URL handler.
+ * Bytes following the end of the body are left for the next request.
+ */
+static cy_rslt_t http_server_process_request_body( cy_http_stream_t *stream, char *data, uint32_t length, uint32_t *consumed )
+{
+    const cy_http_page_t*   page_found     = stream->request.page_found;
+    cy_http_chunked_state_t chunked_state;
+    uint32_t                decoded_length = 0;
+    uint32_t                body_length;
+    int32_t                 generator_result;
+
+    cy_http_message_body_t http_message_body =
+    {
+        .data                         = NULL,
+        .data_length                  = 0,
+        .data_remaining               = 0,
+        .is_chunked_transfer          = false,
+        .mime_type                    = stream->request.mime_type,
+        .request_type                 = stream->request.request_type,
+        .end_of_body                  = true
+    };
+
+    if( stream->request.chunked.state != CY_HTTP_CHUNKED_NONE )
+    {
+        chunked_state = http_server_chunked_decode( &stream->request.chunked, (uint8_t*)data, length, &decoded_length, consumed );
+        if( chunked_state == CY_HTTP_CHUNKED_ERROR )
+        {
+            hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : Malformed chunked body\r\n", __FUNCTION__ );
+            return CY_RSLT_ERROR;
+        }
+
+        /* Packets holding nothing but chunk framing are not passed on, unless they end the body */
+        if( ( decoded_length == 0 ) && ( chunked_state != CY_HTTP_CHUNKED_DONE ) )
+        {
+            return CY_RSLT_SUCCESS;
+        }
+
+        http_message_body.data = ( decoded_length != 0 ) ? (uint8_t*)data : NULL;
+        http_message_body.data_length = decoded_length;
+        http_message_body.data_remaining = stream->request.chunked.chunk_remaining;
+        http_message_body.is_chunked_transfer = true;
+        http_message_body.end_of_body = ( chunked_state == CY_HTTP_CHUNKED_DONE );
+    }
+    else
+    {
+        /* Never hand over more than the declared Content-Length */
+        body_length = ( length < stream->request.data_remaining ) ? length : stream->request.data_remaining;
+        stream->request.data_remaining -= body_length;
+        *consumed = body_length;
+
+        http_message_body.data = (uint8_t*)data;
+        http_message_body.data_length = body_length;
+        http_message_body.data_remaining = stream->request.data_remaining;
+        http_message_body.end_of_body = ( stream->request.data_remaining == 0 );
+    }
+
+    /* currently we only handle content length > MTU for RAW_DYNAMIC_URL_CONTENT and cy_DYNAMIC_CONTENT; the body of any other request,
+     * or of a request the server answered itself, is skipped */
+    if( ( ( page_found->url_content_type != CY_RAW_DYNAMIC_URL_CONTENT ) && ( page_found->url_content_type != CY_DYNAMIC_URL_CONTENT ) ) ||
+        ( stream->request.request_type == CY_HTTP_REQUEST_OPTIONS ) )
+    {
+        return CY_RSLT_SUCCESS;
+    }
+
+    hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : Invoking the URL generator to process partial data\r\n", __FUNCTION__ );
+    generator_result = page_found->url_content.dynamic_data.generator( page_found->url, NULL, &stream->response, page_found->url_content.dynamic_data.arg, &http_message_body );
+    if( ( generator_result != 0 ) && ( http_server_request_body_pending( stream ) == true ) )
+    {
+        /* The URL handler gave up on the request body; the rest of it cannot be told apart from a new request */
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : Request body rejected by the URL handler\r\n", __FUNCTION__ );
+        http_server_request_body_abandon( stream );
+        return CY_RSLT_ERROR;
+    }
+
+    /* We got all fragmented packets of http request now send the response */
+    if( http_server_request_body_pending( stream ) == false )
+    {
+       /* Disable chunked transfer as it was enabled previously in library itself and then flush the data */
+       if( page_found->url_content_type == CY_DYNAMIC_URL_CONTENT )
+       {
+           cy_http_server_response_stream_disable_chunked_transfer( &stream->response );
+       }
+
+       CY_VERIFY( cy_http_server_response_stream_flush( &stream->response ) );
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*
+ * Processes the request, or the part of a request body, at the start of data. The number of bytes that belong to it is
+ * returned in consumed; any bytes after that start the next pipelined request. All of data is consumed when the request
+ * header is incomplete, in which case it is cached until the rest arrives.
+ */
+static cy_rslt_t http_server_parse_request( cy_http_server_info_t *server, cy_http_stream_t *stream, char *data, uint32_t length, uint32_t *consumed )
+{
+    cy_rslt_t      result                        = CY_RSLT_SUCCESS;
+    bool           disconnect_current_connection = false;
+    char*          start_of_url                  = NULL; /* Suppress compiler warning */
+    uint16_t       url_length                    = 0;    /* Suppress compiler warning */
+    char*          request_string                = NULL;
+    uint32_t       request_length;
+    uint32_t       previously_cached_length      = 0;
+    uint32_t       copy_length;
+    bool           header_cached;
+    uint32_t       request_end;
+    cy_http_reassembly_buffer_t* reassembly;
+    cy_http_request_parser_t* parser             = &stream->request.parser;
+    cy_http_parser_state_t    parser_state       = CY_HTTP_PARSER_REQUEST_LINE;
+    cy_http_chunked_state_t   chunked_state;
+    uint32_t                  decoded_length     = 0;
+    uint32_t                  chunked_length     = 0;
+
+    cy_http_message_body_t http_message_body =
+    {
+        .data                         = NULL,
+        .data_length                  = 0,
+        .data_remaining               = 0,
+        .is_chunked_transfer          = false,
+        .mime_type                    = MIME_UNSUPPORTED,
+        .request_type                 = CY_HTTP_REQUEST_UNDEFINED,
+        .end_of_body                  = true
+    };
+
+    request_string = data;
+    request_length = length;
+    *consumed      = length;
+
+    /* Code allows to support if content length > MTU then send data to callback registered for particular page_found. */
+    if( ( stream->request.page_found != NULL ) && ( http_server_request_body_pending( stream ) == true ) )
+    {
+        result = http_server_process_request_body( stream, data, length, consumed );
+        if( result != CY_RSLT_SUCCESS )
+        {
+            *consumed = length;
+            cy_http_server_response_stream_disconnect( &stream->response );
+        }
+        return result;
+    }
+
+    /* A new request starts with a fresh parser. When part of the header has already been received, the parser resumes on
+     * the reassembled request instead, from the point at which the previous packet ran out.
+     */
+    reassembly    = stream->request.reassembly;
+    header_cached = ( reassembly != NULL ) && ( reassembly->length > 0 );
+    if( header_cached == false )
+    {
+        http_server_parser_reset( parser, server->header_interest );
+        parser_state = http_server_parser_execute( parser, request_string, request_length );
+    }
+
+    if( ( header_cached == true ) || ( parser_state < CY_HTTP_PARSER_COMPLETE ) )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG,"%s() : ----- ### DBG : Caching the request\r\n", __FUNCTION__ );
+
+        if( reassembly == NULL )
+        {
+            if( cy_linked_list_remove_node_from_front( &server->free_reassembly_list, (cy_linked_list_node_t**)&reassembly ) != CY_RSLT_SUCCESS )
+            {
+                hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : No reassembly buffer available\r\n", __FUNCTION__ );
+                http_server_reject_request( server, stream, CY_HTTP_503_TYPE );
+                disconnect_current_connection = true;
+                goto exit;
+            }
+            reassembly->length = 0;
+            stream->request.reassembly = reassembly;
+        }
+
+        /* Only as much as fits is taken; what follows the end of the header is processed from the packet itself */
+        previously_cached_length = reassembly->length;
+        copy_length = HTTP_SERVER_REASSEMBLY_BUFFER_SIZE - reassembly->length;
+        if( copy_length > request_length )
+        {
+            copy_length = request_length;
+        }
+        /* A packet received straight into the buffer is already in place */
+        if( request_string != reassembly->data + reassembly->length )
+        {
+            memmove( reassembly->data + reassembly->length, request_string, copy_length );
+        }
+        reassembly->length += copy_length;
+
+        parser_state = http_server_parser_execute( parser, reassembly->data, reassembly->length );
+        if( parser_state < CY_HTTP_PARSER_COMPLETE )
+        {
+            /* The whole buffer is the largest connection budget, so a full buffer always exceeds it */
+            if( reassembly->length >= server->memory_budget->connection )
+            {
+                hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : Request exceeds %d bytes\r\n", __FUNCTION__, (int) server->memory_budget->connection );
+                http_server_release_reassembly_buffer( server, stream );
+                http_server_reject_request( server, stream, CY_HTTP_431_TYPE );
+                disconnect_current_connection = true;
+            }
+            else if( ( server->memory_budget->total != 0 ) &&
+                     ( server->memory_usage.header_bytes - stream->request.memory_held + reassembly->length > server->memory_budget->total ) )
+            {
+                hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : Requests held exceed %d bytes\r\n", __FUNCTION__, (int) server->memory_budget->total );
+                http_server_release_reassembly_buffer( server, stream );
+                http_server_reject_request( server, stream, CY_HTTP_503_TYPE );
+                disconnect_current_connection = true;
+            }
+            else
+            {
+                hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : Not found the end of request\r\n", __FUNCTION__ );
+                http_server_account_memory( server, stream, reassembly->length );
+            }
+            goto exit;
+        }
+
+        request_string = reassembly->data;
+        request_length = reassembly->length;
+    }
+
+    /* The body of a request must be delimited in a single way, or its end, and so the start of the next request on the
+     * connection, is ambiguous. A request that cannot be parsed is answered, and nothing more is read from its connection.
+     */
+    if( ( parser_state == CY_HTTP_PARSER_ERROR ) ||
+        ( ( parser->has_transfer_encoding == true ) && ( ( parser->has_content_length == true ) || ( parser->is_chunked == false ) ) ) )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : Malformed request header\r\n", __FUNCTION__ );
+        http_server_write_error_response( stream, CY_HTTP_400_TYPE );
+        disconnect_current_connection = true;
+        result = CY_RSLT_ERROR;
+        goto exit;
+    }
+
+    /* Check if this is a close request */
+    if( parser->connection_close == true )
+    {
+        disconnect_current_connection = true;
+    }
+
+    /* Headers can be looked up by the URL handler until this request has been dispatched */
+    parser->headers.base = request_string;
+
+    /* Verify we have enough data to start processing */
+    if( request_length < MINIMUM_REQUEST_LINE_LENGTH )
+    {
+        http_server_write_error_response( stream, CY_HTTP_400_TYPE );
+        disconnect_current_connection = true;
+        result = CY_RSLT_ERROR;
+        goto exit;
+    }
+
+    /* First extract the URL from the packet */
+    hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : Extract the request type\r\n", __FUNCTION__ );
+    result = http_server_get_request_type_and_url( request_string, (uint16_t)parser->request_line_length, &http_message_body.request_type, &start_of_url, &url_length );
+    if( result == CY_RSLT_ERROR )
+    {
+        http_server_write_error_response( stream, ( http_message_body.request_type == CY_HTTP_REQUEST_UNDEFINED ) ? CY_HTTP_501_TYPE : CY_HTTP_400_TYPE );
+        disconnect_current_connection = true;
+        goto exit;
+    }
+
+    hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : request type : %d \r\n", __FUNCTION__, http_message_body.request_type );
+
+    /* Now extract packet payload info such as data, data length, data type and message length */
+    hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : Extract payload\r\n", __FUNCTION__ );
+    /* Payload starts just after the header; if there is no payload after header just set data pointer to NULL */
+    if( parser->header_length < request_length )
+    {
+        http_message_body.data = (uint8_t*) ( request_string + parser->header_length );
+    }
+    else
+    {
+        http_message_body.data = NULL;
+        http_message_body.data_length = 0;
+    }
+
+    hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : Extract content type\r\n", __FUNCTION__ );
+    if( parser->content_type_length != 0 )
+    {
+        http_message_body.mime_type = http_server_get_mime_type( request_string + parser->content_type_offset );
+    }
+    else
+    {
+        http_message_body.mime_type = MIME_TYPE_ALL;
+    }
+
+    hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : content type : %d \r\n", __FUNCTION__, http_message_body.mime_type );
+
+    /* Chunked transfer coding takes precedence over Content-Length */
+    if( parser->is_chunked == true )
+    {
+        /* The chunk framing is removed here; the application only receives the chunk data */
+        http_message_body.is_chunked_transfer = true;
+        stream->request.data_remaining = 0;
+        stream->request.chunked.state = CY_HTTP_CHUNKED_SIZE;
+        stream->request.chunked.chunk_remaining = 0;
+        stream->request.chunked.has_size = false;
+
+        chunked_state = CY_HTTP_CHUNKED_SIZE;
+        if( http_message_body.data != NULL )
+        {
+            chunked_state = http_server_chunked_decode( &stream->request.chunked, (uint8_t*) ( request_string + parser->header_length ),
+                                                        request_length - parser->header_length, &decoded_length, &chunked_length );
+            if( chunked_state == CY_HTTP_CHUNKED_ERROR )
+            {
+                hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : Malformed chunked body\r\n", __FUNCTION__ );
+                result = CY_RSLT_ERROR;
+                disconnect_current_connection = true;
+                goto exit;
+            }
+        }
+
+        http_message_body.data = ( decoded_length != 0 ) ? http_message_body.data : NULL;
+        http_message_body.data_length = decoded_length;
+        http_message_body.data_remaining = stream->request.chunked.chunk_remaining;
+        http_message_body.end_of_body = ( chunked_state == CY_HTTP_CHUNKED_DONE );
+    }
+    else
+    {
+        stream->request.chunked.state = CY_HTTP_CHUNKED_NONE;
+
+        /* When content-length : X is present but there is no data in the payload, the application should still be informed
+         * about the correct remaining data length so it can take appropriate action
+         */
+        if( parser->has_content_length == true )
+        {
+            if( http_message_body.data != NULL )
+            {
+                http_message_body.data_length = request_length - parser->header_length;
+                if( http_message_body.data_length > parser->content_length )
+                {
+                    http_message_body.data_length = parser->content_length;
+                }
+            }
+
+            http_message_body.data_remaining = parser->content_length - http_message_body.data_length;
+
+            stream->request.data_remaining = http_message_body.data_remaining;
+        }
+        else
+        {
+            http_message_body.data_length = 0;
+            stream->request.data_remaining = 0;
+        }
+        http_message_body.end_of_body = ( stream->request.data_remaining == 0 );
+    }
+    stream->request.mime_type = http_message_body.mime_type;
+    stream->request.request_type = http_message_body.request_type;
+
+    /* Whatever follows the body in this packet belongs to the next request */
+    request_end = parser->header_length + ( ( parser->is_chunked == true ) ? chunked_length : http_message_body.data_length );
+    *consumed   = request_end - previously_cached_length;
+
+    hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : Process the URL request\r\n", __FUNCTION__ );
+    result = http_server_process_url_request( stream, *server->route_set, start_of_url, url_length, &http_message_body );
+    if( ( result != CY_RSLT_SUCCESS ) && ( http_server_request_body_pending( stream ) == true ) )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : Request body rejected by the URL handler\r\n", __FUNCTION__ );
+        http_server_request_body_abandon( stream );
+        disconnect_current_connection = true;
+    }
+
+exit:
+    /* The request buffer does not outlive this call */
+    stream->request.parser.headers.base = NULL;
+    stream->request.query.base          = NULL;
+    stream->request.path_parameter_count = 0;
+
+    /* A reassembled header is done with once processed; the buffer itself is released after the packet */
+    if( ( parser_state >= CY_HTTP_PARSER_COMPLETE ) && ( stream->request.reassembly != NULL ) )
+    {
+        stream->request.reassembly->length = 0;
+        http_server_account_memory( server, stream, 0 );
+    }
+
+    if( disconnect_current_connection == true )
+    {
+        /* Nothing after a request that closes the connection is processed */
+        *consumed = length;
+        cy_http_server_response_stream_disconnect( &stream->response );
+    }
+
+    return result;
+}
+
+/*
+ * Processes a received packet. HTTP/1.1 clients may pipeline requests, so the packet is split into every request it
+ * holds; they are handled one after another, which also sends their responses in request order. A partial request at
+ * the end of the packet is cached until the next packet completes it.
+ */
+static cy_rslt_t http_server_parse_receive_packet( cy_http_server_info_t *server, cy_http_stream_t *stream, char *data, uint32_t length )
+{
+    cy_rslt_t      result                        = CY_RSLT_SUCCESS;
+    char*          request_string                = data;
+    uint32_t       request_length                = length;
+    uint32_t       consumed;
+    uint16_t       callback_length;
+
+    /* If application registers a receive callback, call the callback before further processing */
+    if( server->receive_callback != NULL )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "####### HTTP Request Received : Payload-Len = [%d], Payload = [%.*s]\r\n", (int)request_length, (int)request_length, request_string );
+
+        /* A single received packet never exceeds HTTP_SERVER_MAX_RECEIVE_SIZE */
+        callback_length = (uint16_t) request_length;
+        result = server->receive_callback( &stream->response, (uint8_t**)&request_string, &callback_length );
+        request_length = callback_length;
+        if( result != CY_RSLT_SUCCESS )
+        {
+            if( result != CY_RSLT_HTTP_SERVER_ERROR_PARTIAL_RESULTS )
+            {
+                cy_http_server_response_stream_disconnect( &stream->response );
+            }
+            return result;
+        }
+    }
+
+    do
+    {
+        result = http_server_parse_request( server, stream, request_string, request_length, &consumed );
+        request_string += consumed;
+        request_length -= consumed;
+    } while( ( request_length > 0 ) && ( consumed > 0 ) );
+
+    return result;
+}
+
+/*
+ * Builds the complete response header of a static page, as cy_http_server_response_stream_write_header would write it
+ * for a GET request. Without memory for it the header is written field by field on each request instead.
+ */
+static void http_server_build_static_header( cy_http_page_t *page )
+{
+    cy_http_mime_type_t mime_type = page->mime;
+    int                 length;
+    char                *header;
+
+    length = snprintf( NULL, 0, "%s" CRLF HTTP_HEADER_CONTENT_TYPE "%s" CRLF HTTP_HEADER_KEEP_ALIVE CRLF HTTP_HEADER_CONTENT_LENGTH "%lu" CRLF_CRLF,
+                       cy_http_status_codes[ CY_HTTP_200_TYPE ], http_mime_array[ mime_type ], (unsigned long) page->url_content.static_data.length );
+    header = malloc( (size_t) length + 1 );
+    if( header == NULL )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : Not enough memory\r\n", __FUNCTION__ );
+        return;
+    }
+
+    snprintf( header, (size_t) length + 1, "%s" CRLF HTTP_HEADER_CONTENT_TYPE "%s" CRLF HTTP_HEADER_KEEP_ALIVE CRLF HTTP_HEADER_CONTENT_LENGTH "%lu" CRLF_CRLF,
+              cy_http_status_codes[ CY_HTTP_200_TYPE ], http_mime_array[ mime_type ], (unsigned long) page->url_content.static_data.length );
+    page->url_content.static_data.header        = header;
+    page->url_content.static_data.header_length = (uint32_t) length;
+}
+
+/* Appends a resource to a route set being built; its URL has been checked by http_server_route_check */
+static void http_server_add_page( cy_http_server_object_t *server_obj, cy_http_route_set_t *set, const cy_http_resource_t *resource )
+{
+    cy_http_page_t *page;
+
+    page = &set->pages[ set->resource_count ];
+    page->url_content_type = resource->url_resource_type;
+    page->mime_type        = (char*) resource->mime_type;
+    page->mime             = http_server_get_mime_type( resource->mime_type );
+    page->url              = (char*) resource->url;
+    page->method_response  = NULL;
+    page->methods          = http_server_default_methods( resource->url_resource_type );
+    page->accepted_methods = page->methods | HTTP_UNCHECKED_METHODS;
+
+    if( resource->url_resource_type == CY_DYNAMIC_URL_CONTENT || resource->url_resource_type == CY_RAW_DYNAMIC_URL_CONTENT )
+    {
+        cy_resource_dynamic_data_t* dynamic_resource = (cy_resource_dynamic_data_t*) resource->resource_data;
+
+        page->url_content.dynamic_data.generator      = dynamic_resource->resource_handler;
+        page->url_content.dynamic_data.arg            = dynamic_resource->arg;
+        page->url_content.dynamic_data.expect_handler = dynamic_resource->expect_handler;
+    }
+    else
+    {
+        cy_resource_static_data_t* static_resource = (cy_resource_static_data_t*) resource->resource_data;
+
+        page->url_content.static_data.ptr    = static_resource->data;
+        page->url_content.static_data.length = static_resource->length;
+        page->url_content.static_data.header = NULL;
+
+        if( resource->url_resource_type == CY_STATIC_URL_CONTENT )
+        {
+            /* The response header of a static page never changes, so GET and HEAD requests send a copy built once here.
+             * A server created in application memory does not use the heap, and writes the header on each request.
+             */
+            if( server_obj->http_server.static_memory == NULL )
+            {
+                http_server_build_static_header( page );
+            }
+        }
+    }
+
+    if( resource->methods != 0 )
+    {
+        http_server_set_page_methods( server_obj, page, resource->methods );
+    }
+
+    http_server_route_add( &set->routes, resource->url, set->resource_count );
+    set->resource_count++;
+}
+
+/* Sets the request methods of a page of a route set being built, see cy_http_server_set_resource_methods */
+static void http_server_set_page_methods( cy_http_server_object_t *server_obj, cy_http_page_t *page, uint8_t methods )
+{
+    uint8_t takeable = HTTP_ALL_METHODS;
+
+    /* OPTIONS is always answered, and a static page cannot take the methods only a URL processor handles */
+    if( ( page->url_content_type != CY_DYNAMIC_URL_CONTENT ) && ( page->url_content_type != CY_RAW_DYNAMIC_URL_CONTENT ) )
+    {
+        takeable = http_server_default_methods( page->url_content_type ) | HTTP_UNCHECKED_METHODS;
+    }
+    page->methods          = ( methods | HTTP_METHOD_BIT( CY_HTTP_REQUEST_OPTIONS ) ) & takeable;
+    page->accepted_methods = page->methods;
+    page->method_response  = NULL;
+    if( server_obj->http_server.static_memory == NULL )
+    {
+        http_server_build_method_response( page );
+    }
+}
+
+/* Request methods a page of the given type answers until the application sets them */
+static uint8_t http_server_default_methods( cy_url_resource_type url_resource_type )
+{
+    switch( url_resource_type )
+    {
+        case CY_STATIC_URL_CONTENT:
+            return HTTP_STATIC_METHODS;
+        case CY_DYNAMIC_URL_CONTENT:
+            return HTTP_DYNAMIC_METHODS;
+        case CY_RAW_DYNAMIC_URL_CONTENT:
+            return HTTP_RAW_DYNAMIC_METHODS;
+        default:
+            return HTTP_RAW_STATIC_METHODS;
+    }
+}
+
+/*
+ * Builds the 405 response of a page whose methods the application set, so a request with any other method is
+ * answered with a single write. Without memory for it the response is formatted on each such request instead.
+ */
+static void http_server_build_method_response( cy_http_page_t *page )
+{
+    char     response[ HTTP_ALLOW_RESPONSE_SIZE ];
+    uint32_t length;
+
+    length = http_server_format_allow_response( response, CY_HTTP_405_TYPE, page->methods );
+    page->method_response = malloc( length );
+    if( page->method_response == NULL )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : Not enough memory\r\n", __FUNCTION__ );
+        return;
+    }
+
+    memcpy( page->method_response, response, length );
+    page->method_response_length = (uint16_t) length;
+}
+
+/* Lays out the memory of a server created with cy_http_server_create_static */
+static void http_server_get_static_layout( uint16_t max_sockets, cy_http_server_static_layout_t *layout )
+{
+    layout->route_sets           = HTTP_SERVER_STATIC_ALIGN( sizeof(cy_http_server_object_t) );
+    layout->streams              = layout->route_sets + ( 2 * HTTP_SERVER_STATIC_ALIGN( HTTP_ROUTE_SET_SIZE( MAX_NUMBER_OF_HTTP_SERVER_RESOURCES ) ) );
+    layout->reassembly_buffers   = layout->streams + HTTP_SERVER_STATIC_ALIGN( sizeof(cy_stream_node_t) * max_sockets );
+    layout->client_sockets       = layout->reassembly_buffers + HTTP_SERVER_STATIC_ALIGN( sizeof(cy_http_reassembly_buffer_t) * CY_HTTP_SERVER_REASSEMBLY_BUFFERS( max_sockets ) );
+    layout->connect_thread_stack = layout->client_sockets + HTTP_SERVER_STATIC_ALIGN( sizeof(cy_tcp_socket_t) * max_sockets );
+    layout->event_thread_stack   = layout->connect_thread_stack + HTTP_SERVER_STATIC_ALIGN( HTTP_SERVER_CONNECT_THREAD_STACK_SIZE );
+    layout->size                 = layout->event_thread_stack + HTTP_SERVER_STATIC_ALIGN( HTTP_SERVER_EVENT_THREAD_STACK_SIZE );
+}
+
+/* Formats a body-less response listing the given request methods in an Allow header into a buffer of HTTP_ALLOW_RESPONSE_SIZE bytes */
+static uint32_t http_server_format_allow_response( char *response, cy_http_status_codes_t status_code, uint8_t methods )
+{
+    uint32_t  length;
+    uint32_t  type;
+    bool      first = true;
+
+    length = (uint32_t) snprintf( response, HTTP_ALLOW_RESPONSE_SIZE, "%s" CRLF HTTP_HEADER_ALLOW, cy_http_status_codes[ status_code ] );
+    for( type = 0; type < CY_HTTP_REQUEST_UNDEFINED; type++ )
+    {
+        if( ( methods & HTTP_METHOD_BIT( type ) ) != 0 )
+        {
+            if( first == false )
+            {
+                response[ length++ ] = ',';
+                response[ length++ ] = ' ';
+            }
+            /* The token without its trailing space is the method name */
+            memcpy( response + length, http_method_tokens[ type ], http_method_token_lengths[ type ] - 1U );
+            length += http_method_token_lengths[ type ] - 1U;
+            first = false;
+        }
+    }
+    length += (uint32_t) snprintf( response + length, HTTP_ALLOW_RESPONSE_SIZE - length, CRLF HTTP_HEADER_CONTENT_LENGTH "0" CRLF HTTP_HEADER_KEEP_ALIVE CRLF_CRLF );
+
+    return length;
+}
+
+/* Writes a complete body-less response and flushes it */
+static cy_rslt_t http_server_write_bodyless_response( cy_http_response_stream_t *stream, const char *response, uint32_t length )
+{
+    cy_rslt_t result;
+
+    cy_rtos_get_mutex( &stream->mutex, CY_RTOS_NEVER_TIMEOUT );
+    result = cy_tcp_stream_write( &stream->tcp_stream, response, length );
+    cy_rtos_set_mutex( &stream->mutex );
+    if( result != CY_RSLT_SUCCESS )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\ncy_tcp_stream_write() failed with Error : [0x%X] ", (unsigned int)result );
+        return result;
+    }
+
+    return cy_http_server_response_stream_flush( stream );
+}
+
+/* Writes a body-less response listing the given request methods in an Allow header */
+static cy_rslt_t http_server_write_allow_response( cy_http_response_stream_t *stream, cy_http_status_codes_t status_code, uint8_t methods )
+{
+    char      response[ HTTP_ALLOW_RESPONSE_SIZE ];
+    uint32_t  length;
+
+    length = http_server_format_allow_response( response, status_code, methods );
+    return http_server_write_bodyless_response( stream, response, length );
+}
+
+/* Writes the 405 response of a page, prebuilt when the page's methods were set, or formatted now otherwise */
+static cy_rslt_t http_server_write_method_response( cy_http_response_stream_t *stream, const cy_http_page_t *page )
+{
+    if( page->method_response != NULL )
+    {
+        return http_server_write_bodyless_response( stream, page->method_response, page->method_response_length );
+    }
+    return http_server_write_allow_response( stream, CY_HTTP_405_TYPE, page->methods );
+}
+
+/*
+ * Decides on an Expect: 100-continue request once its headers are parsed and its URL is resolved. The route's expect
+ * handler, if any, may reject the request with a final status; otherwise 100 Continue is sent so the client starts
+ * sending the body.
+ */
+static cy_http_status_codes_t http_server_answer_expect_continue( cy_http_stream_t *stream, const cy_http_page_t *page_found, const char *url,
+                                                                  const char *url_query_parameters, const cy_http_message_body_t *http_message_body )
+{
+    cy_http_status_codes_t status_code = CY_HTTP_200_TYPE;
+    cy_rslt_t              result;
+
+    if( ( ( page_found->url_content_type == CY_DYNAMIC_URL_CONTENT ) || ( page_found->url_content_type == CY_RAW_DYNAMIC_URL_CONTENT ) ) &&
+        ( page_found->url_content.dynamic_data.expect_handler != NULL ) )
+    {
+        status_code = page_found->url_content.dynamic_data.expect_handler( url, url_query_parameters, &stream->response,
+                                                                           page_found->url_content.dynamic_data.arg, http_message_body );
+        if( status_code >= CY_HTTP_400_TYPE )
+        {
+            hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : Request body rejected with status [%d]\r\n", __FUNCTION__, status_code );
+            return status_code;
+        }
+        status_code = CY_HTTP_200_TYPE;
+    }
+
+    cy_rtos_get_mutex( &stream->response.mutex, CY_RTOS_NEVER_TIMEOUT );
+    result = cy_tcp_stream_write( &stream->response.tcp_stream, HTTP_100_CONTINUE_RESPONSE, strlen( HTTP_100_CONTINUE_RESPONSE ) );
+    if( result == CY_RSLT_SUCCESS )
+    {
+        result = cy_tcp_stream_flush( &stream->response.tcp_stream );
+    }
+    cy_rtos_set_mutex( &stream->response.mutex );
+    if( result != CY_RSLT_SUCCESS )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nFailed to send 100 Continue : [0x%X] ", (unsigned int)result );
+    }
+
+    return status_code;
+}
+
+cy_rslt_t http_server_process_url_request( cy_http_stream_t *stream, const cy_http_route_set_t *route_set, char *url, uint32_t url_length, cy_http_message_body_t *http_message_body )
+{
+    char                     *url_query_parameters = NULL;
+    uint32_t                 query_offset;
+    uint32_t                 query_length = 0;
+    uint16_t                 decoded_length;
+    bool                     is_escaped;
+    cy_http_page_t           *page_found = NULL;
+    cy_http_mime_type_t      mime_type = MIME_TYPE_ALL;
+    cy_http_status_codes_t   status_code;
+    cy_rslt_t                result = CY_RSLT_SUCCESS;
+    uint8_t                  allowed_methods = 0;
+
+    url[ url_length ] = '\x00';
+
+    /* The URL is split before it is decoded, so an escaped '?', '&' or '=' stays part of the path or parameter it is in */
+    query_offset = http_server_find_delimiter( url, url_length, '?', '?', '?', '?' );
+    if( query_offset != url_length )
+    {
+        query_length = url_length - query_offset - 1;
+        url_length = query_offset;
+        url[ query_offset ] = '\x00';
+        url_query_parameters = url + query_offset + 1;
+    }
+
+    /* The path ends at the first NUL, which may come from a decoded %00 */
+    decoded_length = http_server_remove_escaped_characters( url, (uint16_t) url_length, url, (uint16_t) url_length );
+    is_escaped     = ( decoded_length != 0 ) || ( url_length == 0 );
+    url_length     = http_server_find_delimiter( url, decoded_length, '\0', '\0', '\0', '\0' );
+    url[ url_length ] = '\x00';
+
+    /* Split the query string once so that URL handlers can look up parameters without rescanning it. A URL that is not
+     * validly escaped is not found, as when it was decoded as a whole
+     */
+    if( ( is_escaped == false ) ||
+        ( http_server_query_index_build( &stream->request.query, url_query_parameters, query_length ) == false ) )
+    {
+        url_length = 0;
+        url[ 0 ] = '\x00';
+        url_query_parameters = NULL;
+        http_server_query_index_build( &stream->request.query, NULL, 0 );
+    }
+
+    /* The response to the previous request may have been a HEAD one */
+    cy_rtos_get_mutex( &stream->response.mutex, CY_RTOS_NEVER_TIMEOUT );
+    stream->response.omit_payload = false;
+    cy_rtos_set_mutex( &stream->response.mutex );
+
+    /* Find URL in server page database; no resource is registered while route_set is NULL */
+    if( ( route_set != NULL ) &&
+        ( http_server_find_url_in_page_database( url, url_length, http_message_body, route_set->pages, &route_set->routes,
+                                                 stream->request.path_parameters, &stream->request.path_parameter_count, &page_found, &mime_type ) == CY_RSLT_SUCCESS ) )
+    {
+        stream->request.page_found = page_found;
+        status_code = CY_HTTP_200_TYPE; /* OK */
+    }
+    else
+    {
+        stream->request.page_found = NULL;
+        status_code = CY_HTTP_404_TYPE; /* Not Found */
+
+        /* "OPTIONS *" asks about the server as a whole */
+        if( ( http_message_body->request_type == CY_HTTP_REQUEST_OPTIONS ) && ( strcmp( url, OPTIONS_ASTERISK_URL ) == COMPARE_MATCH ) )
+        {
+            status_code = CY_HTTP_204_TYPE; /* No Content */
+            allowed_methods = HTTP_ALL_METHODS;
+        }
+    }
+
+    /* Requests a page does not take are answered here without calling its URL processor. Unless the application set
+     * the methods of the page, GET, POST and PUT reach every page.
+     */
+    if( ( status_code == CY_HTTP_200_TYPE ) &&
+        ( ( page_found->accepted_methods & HTTP_METHOD_BIT( http_message_body->request_type ) ) == 0 ) )
+    {
+        status_code = CY_HTTP_405_TYPE; /* Method Not Allowed */
+    }
+    else if( ( status_code == CY_HTTP_200_TYPE ) && ( http_message_body->request_type == CY_HTTP_REQUEST_OPTIONS ) )
+    {
+        /* Answered from the page's method set without calling its URL processor */
+        status_code = CY_HTTP_204_TYPE; /* No Content */
+        allowed_methods = page_found->methods;
+    }
+
+    /* Expectations are answered before the URL handler runs, so a rejected request body is never transferred */
+    if( stream->request.parser.expect_unsupported == true )
+    {
+        status_code = CY_HTTP_417_TYPE; /* Expectation Failed */
+    }
+    else if( ( status_code == CY_HTTP_200_TYPE ) && ( stream->request.parser.expect_continue == true ) &&
+             ( http_server_request_body_pending( stream ) == true ) )
+    {
+        status_code = http_server_answer_expect_continue( stream, page_found, url, url_query_parameters, http_message_body );
+    }
+
+    if( status_code == CY_HTTP_200_TYPE )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : URL content type = [%d]\r\n", __FUNCTION__, page_found->url_content_type );
+        /* Call the content handler function to write the page content into the packet and adjust the write pointers */
+        switch ( page_found->url_content_type )
+        {
+            case CY_DYNAMIC_URL_CONTENT:
+                hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : CY_DYNAMIC_URL_CONTENT\r\n", __FUNCTION__ );
+                cy_http_server_response_stream_enable_chunked_transfer( &stream->response );
+                cy_http_server_response_stream_write_header( &stream->response, status_code, CHUNKED_CONTENT_LENGTH, CY_HTTP_CACHE_DISABLED, mime_type );
+                /* The generator writes a HEAD response as it would a GET one; only its header may be sent */
+                cy_rtos_get_mutex( &stream->response.mutex, CY_RTOS_NEVER_TIMEOUT );
+                stream->response.omit_payload = ( http_message_body->request_type == CY_HTTP_REQUEST_HEAD );
+                cy_rtos_set_mutex( &stream->response.mutex );
+                result = page_found->url_content.dynamic_data.generator( url, url_query_parameters, &stream->response, page_found->url_content.dynamic_data.arg, http_message_body );
+                /* if the whole request body has been received then just disable chunked transfer and flush the data */
+                if( http_server_request_body_pending( stream ) == false )
+                {
+                    cy_http_server_response_stream_disable_chunked_transfer( &stream->response );
+                    CY_VERIFY( cy_http_server_response_stream_flush( &stream->response ) );
+                }
+                break;
+
+            case CY_RAW_DYNAMIC_URL_CONTENT:
+                hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : CY_RAW_DYNAMIC_URL_CONTENT\r\n", __FUNCTION__ );
+                result = page_found->url_content.dynamic_data.generator( url, url_query_parameters, &stream->response, page_found->url_content.dynamic_data.arg, http_message_body );
+                /* if the whole request body has been received then just flush the response */
+                if( http_server_request_body_pending( stream ) == false )
+                {
+                    CY_VERIFY( cy_http_server_response_stream_flush( &stream->response ) );
+                }
+                break;
+
+            case CY_STATIC_URL_CONTENT:
+                hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : CY_STATIC_URL_CONTENT\r\n", __FUNCTION__ );
+                if( page_found->url_content.static_data.header != NULL )
+                {
+                    CY_VERIFY( cy_http_server_response_stream_write_payload( &stream->response, page_found->url_content.static_data.header, page_found->url_content.static_data.header_length ) );
+                }
+                else
+                {
+                    cy_http_server_response_stream_write_header( &stream->response, status_code, page_found->url_content.static_data.length, CY_HTTP_CACHE_ENABLED, mime_type );
+                }
+                /* A HEAD request gets the header alone */
+                if( http_message_body->request_type != CY_HTTP_REQUEST_HEAD )
+                {
+                    CY_VERIFY( cy_http_server_response_stream_write_payload( &stream->response, page_found->url_content.static_data.ptr, page_found->url_content.static_data.length ) );
+                }
+                CY_VERIFY( cy_http_server_response_stream_flush( &stream->response ) );
+                break;
+
+            case CY_RAW_STATIC_URL_CONTENT: /* This is just a Location header */
+                hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : CY_RAW_STATIC_URL_CONTENT\n", __FUNCTION__ );
+                CY_VERIFY( cy_http_server_response_stream_write_payload( &stream->response, page_found->url_content.static_data.ptr, page_found->url_content.static_data.length ) );
+                CY_VERIFY( cy_http_server_response_stream_flush( &stream->response ) );
+                break;
+
+            case CY_RESOURCE_URL_CONTENT:
+                hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : CY_RESOURCE_URL_CONTENT\r\n", __FUNCTION__ );
+                /* Fall through */
+            case CY_RAW_RESOURCE_URL_CONTENT:
+                hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : CY_RAW_RESOURCE_URL_CONTENT\r\n", __FUNCTION__ );
+                cy_http_server_response_stream_enable_chunked_transfer( &stream->response );
+                cy_http_server_response_stream_write_header( &stream->response, status_code, CHUNKED_CONTENT_LENGTH, CY_HTTP_CACHE_DISABLED, mime_type );
+                cy_http_server_response_stream_write_resource( &stream->response, page_found->url_content.resource_data );
+                cy_http_server_response_stream_disable_chunked_transfer( &stream->response );
+                CY_VERIFY( cy_http_server_response_stream_flush( &stream->response ) );
+                break;
+
+            default:
+                hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : default\r\n", __FUNCTION__ );
+                break;
+        }
+    }
+    else if( status_code == CY_HTTP_204_TYPE )
+    {
+        /* An OPTIONS request; written only now, as an unsupported expectation fails it */
+        result = http_server_write_allow_response( &stream->response, status_code, allowed_methods );
+    }
+    else if( status_code == CY_HTTP_405_TYPE )
+    {
+        /* The page exists, so tell the client which methods it does take */
+        CY_VERIFY( http_server_write_method_response( &stream->response, page_found ) );
+    }
+    else if( status_code >= CY_HTTP_400_TYPE )
+    {
+        cy_http_server_response_stream_write_header( &stream->response, status_code, NO_CONTENT_LENGTH, CY_HTTP_CACHE_DISABLED, MIME_TYPE_TEXT_HTML );
+        CY_VERIFY( cy_http_server_response_stream_flush( &stream->response ) );
+    }
+
+    /* Any request body still to come after an error response would be taken for the next request; the caller closes the connection */
+    if( ( status_code >= CY_HTTP_400_TYPE ) && ( http_server_request_body_pending( stream ) == true ) )
+    {
+        result = CY_RSLT_ERROR;
+    }
+
+    return result;
+}
+
+uint16_t http_server_remove_escaped_characters( char *output, uint16_t output_length, const char *input, uint16_t input_length )
+{
+    uint16_t bytes_copied = 0;
+    uint16_t run_length;
+    int      high_nibble;
+    int      low_nibble;
+
+    while( ( input_length > 0 ) && ( bytes_copied != output_length ) )
+    {
+        /* Copy the run of characters up to the next escape in one step. Decoding may be done in place, so use memmove */
+        run_length = (uint16_t) http_server_find_delimiter( input, input_length, '%', '+', '%', '+' );
+        if( run_length > ( output_length - bytes_copied ) )
+        {
+            run_length = (uint16_t)( output_length - bytes_copied );
+        }
+
+        if( run_length != 0 )
+        {
+            if( output != input )
+            {
+                memmove( output, input, run_length );
+            }
+            output       += run_length;
+            input        += run_length;
+            input_length  = (uint16_t)( input_length - run_length );
+            bytes_copied  = (uint16_t)( bytes_copied + run_length );
+            continue;
+        }
+
+        /* If there is + present in encoded URL then replace with space */
+        if( *input == '+' )
+        {
+            *output++ = ' ';
+            input++;
+            input_length--;
+            bytes_copied++;
+            continue;
+        }
+
+        /* As per RFC 3986 : percent encoding octet is encoded as character triplet, consisting of "%" followed by two hexadecimal digits. If the
+         * two hexadecimal digits are not present (this includes a trailing % and %%) then return as it is invalid encoded URL */
+        if( input_length < 3 )
+        {
+            return 0;
+        }
+
+        high_nibble = http_server_hex_digit_value( input[1] );
+        low_nibble  = http_server_hex_digit_value( input[2] );
+        if( ( high_nibble < 0 ) || ( low_nibble < 0 ) )
+        {
+            return 0;
+        }
+
+        *output++ = (char) ( ( high_nibble << 4 ) | low_nibble );
+        input        += 3;
+        input_length  = (uint16_t)( input_length - 3 );
+        bytes_copied++;
+    }
+
+    return bytes_copied;
+}
+
+/*
+ * Returns the MIME type that request_data starts with; MIME_TYPE_ALL if none. Only the entries of the MIME table with the
+ * same first character as request_data are compared.
+ */
+cy_http_mime_type_t http_server_get_mime_type( const char *request_data )
+{
+    cy_http_mime_type_t mime_type;
+
+    if( request_data != NULL )
+    {
+        switch( request_data[ 0 ] )
+        {
+            case 'a':
+                mime_type = MIME_TYPE_TLV;
+                break;
+
+            case 't':
+                mime_type = MIME_TYPE_TEXT_HTML;
+                break;
+
+            case 'i':
+                mime_type = MIME_TYPE_IMAGE_PNG;
+                break;
+
+            default:
+                return MIME_TYPE_ALL;
+        }
+
+        while( ( mime_type < MIME_TYPE_ALL ) && ( http_mime_array[ mime_type ][ 0 ] == request_data[ 0 ] ) )
+        {
+            if( strncmp( request_data, http_mime_array[ mime_type ], http_mime_lengths[ mime_type ] ) == COMPARE_MATCH )
+            {
+                return mime_type;
+            }
+            mime_type++;
+        }
+        mime_type = MIME_TYPE_ALL;
+    }
+    else
+    {
+        /* If MIME not specified, assumed all supported (according to rfc2616)*/
+        mime_type = MIME_TYPE_ALL;
+    }
+    return mime_type;
+}
+
+cy_rslt_t http_server_get_request_type_and_url( char *request, uint16_t request_length, cy_http_request_type_t *type, char **url_start, uint16_t *url_length )
+{
+    char* end_of_url;
 
-    message.event_type = CY_SOCKET_DISCONNECT_EVENT;
-    message.socket = socket;
+    /* The first character, and for 'P' the second, leaves a single candidate method to be compared */
+    switch( request[0] )
+    {
+        case 'G':
+            *type = CY_HTTP_REQUEST_GET;
+            break;
+        case 'H':
+            *type = CY_HTTP_REQUEST_HEAD;
+            break;
+        case 'D':
+            *type = CY_HTTP_REQUEST_DELETE;
+            break;
+        case 'O':
+            *type = CY_HTTP_REQUEST_OPTIONS;
+            break;
+        case 'P':
+            *type = ( request[1] == 'O' ) ? CY_HTTP_REQUEST_POST :
+                    ( request[1] == 'U' ) ? CY_HTTP_REQUEST_PUT :
+                    ( request[1] == 'A' ) ? CY_HTTP_REQUEST_PATCH : CY_HTTP_REQUEST_UNDEFINED;
+            break;
+        default:
+            *type = CY_HTTP_REQUEST_UNDEFINED;
+            break;
+    }
 
-    hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_INFO, "\nhttp_server_disconnect_callback received for socket : %p\n",message.socket );
-    hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG," \nPushing to event_queue...... \n" );
-    result = cy_rtos_put_queue( &event_queue, &message, 0, 0 );
-    if( result != CY_RSLT_SUCCESS )
+    if( ( *type == CY_HTTP_REQUEST_UNDEFINED ) ||
+        ( memcmp( request, http_method_tokens[ *type ], http_method_token_lengths[ *type ] ) != COMPARE_MATCH ) )
     {
-        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nFailure in pushing to queue : %d \n", (int) result );
-        return;
+        *type = CY_HTTP_REQUEST_UNDEFINED;
+        return CY_RSLT_ERROR;
     }
-    return;
+
+    /* request_length covers the request line only, which must end with the protocol version */
+    if( ( request_length < ( sizeof( HTTP_1_1_TOKEN ) - 1 ) ) ||
+        ( memcmp( request + request_length - ( sizeof( HTTP_1_1_TOKEN ) - 1 ), HTTP_1_1_TOKEN, sizeof( HTTP_1_1_TOKEN ) - 1 ) != COMPARE_MATCH ) )
+    {
+        return CY_RSLT_ERROR;
+    }
+    end_of_url = request + request_length - ( sizeof( HTTP_1_1_TOKEN ) - 1 );
+
+    *url_start = request + http_method_token_lengths[ *type ];
+    *url_length = (uint16_t) ( end_of_url - *url_start );
+
+    if( *url_start > end_of_url )
+    {
+        return CY_RSLT_ERROR;
+    }
+
+    return CY_RSLT_SUCCESS;
 }
 
-void http_server_receive_callback( void *socket )
+/* Finds the first page of a route chain whose MIME type suits the request */
+static bool http_server_route_match_pages( const cy_http_route_table_t *routes, const cy_http_page_t *page_database, uint16_t page,
+                                           const cy_http_message_body_t *http_request, cy_http_page_t **page_found, cy_http_mime_type_t *mime_type )
 {
-    server_event_message_t message;
-    cy_rslt_t result = CY_RSLT_SUCCESS;
+    for( ; page != HTTP_ROUTE_NONE; page = routes->next_page[ page ] )
+    {
+        *mime_type = page_database[ page ].mime;
 
-    message.event_type = CY_SOCKET_PACKET_RECEIVED_EVENT;
-    message.socket = socket;
-    hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG," \nhttp_server_receive_callback received for socket : %p...\n",message.socket );
-    hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG," \nPushing to event_queue...... \n" );
-    result = cy_rtos_put_queue( &event_queue, &message, 0, 0 );
-    if( result != CY_RSLT_SUCCESS )
+        if( ( *mime_type == http_request->mime_type ) || ( http_request->mime_type == MIME_TYPE_ALL ) )
+        {
+            *page_found = (cy_http_page_t*)&page_database[ page ];
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/* Returns the literal child of a route node whose label starts with c, or HTTP_ROUTE_NONE */
+static uint16_t http_server_route_find_child( const cy_http_route_table_t *routes, uint16_t node, char c )
+{
+    uint16_t child = routes->nodes[ node ].first_child;
+
+    while( ( child != HTTP_ROUTE_NONE ) && ( routes->nodes[ child ].label[ 0 ] != c ) )
     {
-        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nfailure in pushing to queue : %d \n", (int) result );
-        return;
+        child = routes->nodes[ child ].next_sibling;
     }
 
-    return;
+    return child;
 }
 
-static cy_rslt_t http_server_parse_receive_packet( cy_http_server_info_t *server, cy_http_stream_t *stream, char *data, uint32_t length )
+/*
+ * Checks a path segment against the type of a segment node, converting the value of a typed one. Returns false if the
+ * segment does not match.
+ */
+static bool http_server_route_segment_value( uint8_t segment_type, const char *segment, uint32_t length, uint32_t *number )
 {
-    cy_rslt_t      result                        = CY_RSLT_SUCCESS;
-    bool           disconnect_current_connection = false;
-    char*          start_of_url                  = NULL; /* Suppress compiler warning */
-    uint16_t       url_length                    = 0;    /* Suppress compiler warning */
-    char*          request_string                = NULL;
-    uint16_t       request_length;
-    uint16_t       new_url_length;
-    char*          message_data_length_string;
-    char*          mime;
-    char*          cached_string_to_be_freed     = NULL;
+    uint64_t value = 0;
+    uint32_t i;
+    char     c;
 
-    cy_http_message_body_t http_message_body =
+    *number = 0;
+    if( segment_type == HTTP_ROUTE_SEGMENT_ANY )
     {
-        .data                         = NULL,
-        .data_length                  = 0,
-        .data_remaining               = 0,
-        .is_chunked_transfer          = false,
-        .mime_type                    = MIME_UNSUPPORTED,
-        .request_type                 = CY_HTTP_REQUEST_UNDEFINED
-    };
+        return true;
+    }
 
-    request_string = data;
-    request_length = length;
+    if( length > ( ( segment_type == HTTP_ROUTE_SEGMENT_U32 ) ? 10U : 8U ) )
+    {
+        return false;
+    }
 
-    /* If application registers a receive callback, call the callback before further processing */
-    if( server->receive_callback != NULL )
+    for( i = 0; i < length; i++ )
+    {
+        c = segment[ i ];
+        if( ( c >= '0' ) && ( c <= '9' ) )
+        {
+            value = ( value * ( ( segment_type == HTTP_ROUTE_SEGMENT_U32 ) ? 10U : 16U ) ) + (uint32_t)( c - '0' );
+        }
+        else if( ( segment_type == HTTP_ROUTE_SEGMENT_HEX ) && ( HTTP_TO_LOWER( c ) >= 'a' ) && ( HTTP_TO_LOWER( c ) <= 'f' ) )
+        {
+            value = ( value * 16U ) + (uint32_t)( HTTP_TO_LOWER( c ) - 'a' + 10 );
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    if( value > 0xFFFFFFFFUL )
+    {
+        return false;
+    }
+
+    *number = (uint32_t) value;
+    return true;
+}
+
+/*
+ * Finds the page of a URL. The longest literal match is preferred: at each node of the trie a literal child is
+ * followed first, then the segment children, then a '*' ending the route. Pages with the same route are tried in
+ * registration order, and routes outside the trie last, so the result does not depend on the order of registration
+ * between an exact route and a wildcard one. The segments matched by segment nodes on the way to the page are
+ * returned in parameters.
+ */
+cy_rslt_t http_server_find_url_in_page_database( char *url, uint32_t length, cy_http_message_body_t *http_request, const cy_http_page_t *page_database, const cy_http_route_table_t *routes,
+                                                 cy_http_path_parameter_t *parameters, uint8_t *parameter_count, cy_http_page_t **page_found, cy_http_mime_type_t *mime_type )
+{
+    cy_http_route_frame_t       stack[ HTTP_ROUTE_MAX_WILDCARD_DEPTH ];
+    cy_http_route_frame_t*      frame;
+    const cy_http_route_node_t* current;
+    cy_http_path_parameter_t*   parameter;
+    uint32_t                    depth    = 0;
+    uint32_t                    position = 0;
+    uint32_t                    segment_length;
+    uint32_t                    number;
+    uint16_t                    node     = HTTP_ROUTE_ROOT;
+    uint16_t                    i;
+
+    if( page_database == NULL || routes == NULL )
+    {
+        return CY_RSLT_ERROR;
+    }
+
+    *parameter_count = 0;
+    while( node != HTTP_ROUTE_NONE )
     {
-        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "####### HTTP Request Received : Payload-Len = [%d], Payload = [%.*s]\r\n", request_length, request_length, request_string );
-#ifdef ENABLE_DEBUG
+        current = &routes->nodes[ node ];
+
+        if( ( position == length ) &&
+            ( http_server_route_match_pages( routes, page_database, current->page, http_request, page_found, mime_type ) == true ) )
+        {
+            return CY_RSLT_SUCCESS;
+        }
+
+        /* Wildcards of the node are only tried if nothing below its literal child matches */
+        if( ( ( current->segment_child != HTTP_ROUTE_NONE ) || ( current->prefix_page != HTTP_ROUTE_NONE ) ) &&
+            ( depth < HTTP_ROUTE_MAX_WILDCARD_DEPTH ) )
+        {
+            stack[ depth ].node            = node;
+            stack[ depth ].position        = position;
+            stack[ depth ].next_segment    = current->segment_child;
+            stack[ depth ].parameter_count = *parameter_count;
+            depth++;
+        }
+
+        node = ( position < length ) ? http_server_route_find_child( routes, node, url[ position ] ) : HTTP_ROUTE_NONE;
+        if( node != HTTP_ROUTE_NONE )
         {
-            int i;
-            for ( i = 0; i < request_length; i++ )
+            current = &routes->nodes[ node ];
+            if( ( current->label_length <= ( length - position ) ) && ( memcmp( url + position, current->label, current->label_length ) == 0 ) )
             {
-                hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%02X ", request_string[i] );
+                position += current->label_length;
+                continue;
             }
-            hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "]\r\n" );
+            node = HTTP_ROUTE_NONE;
         }
-#endif
 
-        result = server->receive_callback( &stream->response, (uint8_t**)&request_string, &request_length );
-        if( result != CY_RSLT_SUCCESS )
+        /* Go back to the deepest node with a wildcard not yet tried */
+        while( ( node == HTTP_ROUTE_NONE ) && ( depth > 0 ) )
         {
-            if( result != CY_RSLT_HTTP_SERVER_ERROR_PARTIAL_RESULTS )
+            frame            = &stack[ depth - 1 ];
+            *parameter_count = frame->parameter_count;
+            if( frame->next_segment != HTTP_ROUTE_NONE )
             {
-                disconnect_current_connection = true;
+                current             = &routes->nodes[ frame->next_segment ];
+                node                = frame->next_segment;
+                frame->next_segment = current->next_sibling;
+
+                segment_length = ( frame->position < length ) ?
+                                 http_server_find_delimiter( url + frame->position, length - frame->position, '/', '/', '/', '/' ) : 0;
+                if( ( segment_length == 0 ) ||
+                    ( http_server_route_segment_value( current->segment_type, url + frame->position, segment_length, &number ) == false ) )
+                {
+                    node = HTTP_ROUTE_NONE;
+                    continue;
+                }
+
+                if( *parameter_count < HTTP_SERVER_MAX_PATH_PARAMETERS )
+                {
+                    parameter               = &parameters[ *parameter_count ];
+                    parameter->value        = url + frame->position;
+                    parameter->value_length = segment_length;
+                    parameter->name         = current->label;
+                    parameter->name_length  = current->label_length;
+                    parameter->number       = number;
+                    ( *parameter_count )++;
+                }
+                position = frame->position + segment_length;
+            }
+            else
+            {
+                depth--;
+                if( http_server_route_match_pages( routes, page_database, routes->nodes[ frame->node ].prefix_page, http_request, page_found, mime_type ) == true )
+                {
+                    return CY_RSLT_SUCCESS;
+                }
             }
-            goto exit;
         }
     }
 
-    /* Check if this is a close request */
-    if( (char*) strnstrn( request_string, request_length, HTTP_HEADER_CLOSE, sizeof( HTTP_HEADER_CLOSE ) - 1 ) != NULL )
+    *parameter_count = 0;
+    for( i = 0; i < routes->glob_count; i++ )
     {
-        disconnect_current_connection = true;
+        if( ( match_string_with_wildcard_pattern( url, length, page_database[ routes->globs[ i ] ].url ) != 0 ) &&
+            ( http_server_route_match_pages( routes, page_database, routes->globs[ i ], http_request, page_found, mime_type ) == true ) )
+        {
+            return CY_RSLT_SUCCESS;
+        }
     }
 
-    /* Code allows to support if content length > MTU then send data to callback registered for particular page_found. */
-    if( stream->request.page_found != NULL )
+    return CY_RSLT_HTTP_SERVER_ERROR_NOT_FOUND;
+}
+
+static uint16_t http_server_route_new_node( cy_http_route_table_t *routes, const char *label, uint16_t label_length )
+{
+    cy_http_route_node_t* node = &routes->nodes[ routes->node_count ];
+
+    node->label         = label;
+    node->label_length  = label_length;
+    node->first_child   = HTTP_ROUTE_NONE;
+    node->next_sibling  = HTTP_ROUTE_NONE;
+    node->segment_child = HTTP_ROUTE_NONE;
+    node->page          = HTTP_ROUTE_NONE;
+    node->prefix_page   = HTTP_ROUTE_NONE;
+    node->segment_type  = HTTP_ROUTE_SEGMENT_ANY;
+
+    return routes->node_count++;
+}
+
+static void http_server_route_table_init( cy_http_route_table_t *routes )
+{
+    routes->node_count = 0;
+    routes->glob_count = 0;
+    (void) http_server_route_new_node( routes, "", 0 );
+}
+
+/* Follows a literal part of a route down from a node, splitting the edge it leaves the trie on, and returns its end */
+static uint16_t http_server_route_insert_literal( cy_http_route_table_t *routes, uint16_t node, const char *label, uint32_t length )
+{
+    cy_http_route_node_t* edge;
+    uint16_t              child;
+    uint16_t              tail;
+    uint32_t              common;
+
+    while( length > 0 )
     {
-        /* currently we only handle content length > MTU for RAW_DYNAMIC_URL_CONTENT and cy_DYNAMIC_CONTENT */
-        if( stream->request.page_found->url_content_type == CY_RAW_DYNAMIC_URL_CONTENT || stream->request.page_found->url_content_type == CY_DYNAMIC_URL_CONTENT )
+        child = http_server_route_find_child( routes, node, label[ 0 ] );
+        if( child == HTTP_ROUTE_NONE )
         {
-            if( stream->request.data_remaining > 0 )
-            {
-                stream->request.data_remaining = (uint16_t)( stream->request.data_remaining -  request_length );
+            child = http_server_route_new_node( routes, label, (uint16_t) length );
+            routes->nodes[ child ].next_sibling = routes->nodes[ node ].first_child;
+            routes->nodes[ node ].first_child   = child;
+            return child;
+        }
 
-                http_message_body.data = (uint8_t*)request_string;
-                http_message_body.data_length = request_length;
-                http_message_body.data_remaining = stream->request.data_remaining;
-                http_message_body.mime_type = stream->request.mime_type;
-                http_message_body.request_type = stream->request.request_type;
+        edge   = &routes->nodes[ child ];
+        common = 1;
+        while( ( common < edge->label_length ) && ( common < length ) && ( edge->label[ common ] == label[ common ] ) )
+        {
+            common++;
+        }
+
+        if( common < edge->label_length )
+        {
+            /* The rest of the edge moves to a new node below it, which keeps its children and pages */
+            tail = http_server_route_new_node( routes, NULL, 0 );
+            routes->nodes[ tail ]               = *edge;
+            routes->nodes[ tail ].label        += common;
+            routes->nodes[ tail ].label_length -= (uint16_t) common;
+            routes->nodes[ tail ].next_sibling  = HTTP_ROUTE_NONE;
+
+            edge->label_length  = (uint16_t) common;
+            edge->first_child   = tail;
+            edge->segment_child = HTTP_ROUTE_NONE;
+            edge->page          = HTTP_ROUTE_NONE;
+            edge->prefix_page   = HTTP_ROUTE_NONE;
+        }
 
-                hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : Invoking the URL generator to process partial data\r\n", __FUNCTION__ );
-                stream->request.page_found->url_content.dynamic_data.generator( stream->request.page_found->url, NULL, &stream->response, stream->request.page_found->url_content.dynamic_data.arg, &http_message_body );
+        node    = child;
+        label  += common;
+        length -= common;
+    }
 
-                /* We got all fragmented packets of http request [as total_data_remaining is 0 ] now send the response */
-                if(stream->request.data_remaining == 0)
-                {
-                   /* Disable chunked transfer as it was enabled previously in library itself and then flush the data */
-                   if( stream->request.page_found->url_content_type == CY_DYNAMIC_URL_CONTENT )
-                   {
-                       cy_http_server_response_stream_disable_chunked_transfer( &stream->response );
-                   }
+    return node;
+}
 
-                   CY_VERIFY( cy_http_server_response_stream_flush( &stream->response ) );
-                }
+/*
+ * Reads a "{name}", "{name:u32}" or "{name:hex}" segment of a route template, at the '{' of template. Returns the
+ * length of the segment up to its '}', or 0 if it is malformed.
+ */
+static uint32_t http_server_route_parse_parameter( const char *template, uint32_t length, uint8_t *segment_type, uint16_t *name_length )
+{
+    uint32_t end  = http_server_find_delimiter( template, length, '}', '}', '}', '}' );
+    uint32_t name = http_server_find_delimiter( template, end, ':', ':', ':', ':' );
+
+    /* The parameter must make up a whole path segment */
+    if( ( end == length ) || ( ( end + 1 < length ) && ( template[ end + 1 ] != '/' ) ) || ( name < 2 ) || ( name > 0xFFFF ) )
+    {
+        return 0;
+    }
+
+    *name_length  = (uint16_t)( name - 1 );
+    *segment_type = HTTP_ROUTE_SEGMENT_ANY;
+    if( name != end )
+    {
+        if( ( ( end - name - 1 ) == ( sizeof( HTTP_ROUTE_U32_TOKEN ) - 1 ) ) && ( memcmp( template + name + 1, HTTP_ROUTE_U32_TOKEN, end - name - 1 ) == COMPARE_MATCH ) )
+        {
+            *segment_type = HTTP_ROUTE_SEGMENT_U32;
+        }
+        else if( ( ( end - name - 1 ) == ( sizeof( HTTP_ROUTE_HEX_TOKEN ) - 1 ) ) && ( memcmp( template + name + 1, HTTP_ROUTE_HEX_TOKEN, end - name - 1 ) == COMPARE_MATCH ) )
+        {
+            *segment_type = HTTP_ROUTE_SEGMENT_HEX;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+
+    return end;
+}
 
-                return CY_RSLT_SUCCESS;
+/* Sorts a registered URL into the route trie or the glob scan, and counts its '*' and '{name}' segments */
+static cy_http_route_kind_t http_server_route_classify( const char *url, size_t length, uint32_t *segments )
+{
+    bool     glob       = ( length > 0xFFFF );
+    bool     parameters = false;
+    uint32_t i;
+    uint8_t  segment_type;
+    uint16_t name_length;
+    uint32_t end;
+
+    *segments = 0;
+    for( i = 0; i < length; i++ )
+    {
+        if( url[ i ] == '?' )
+        {
+            glob = true;
+        }
+        else if( ( url[ i ] == '*' ) && ( i + 1 < length ) )
+        {
+            /* Only a '*' making up a whole path segment matches one segment */
+            glob = glob || ( i == 0 ) || ( url[ i - 1 ] != '/' ) || ( url[ i + 1 ] != '/' );
+            ( *segments )++;
+        }
+        else if( url[ i ] == '{' )
+        {
+            end = ( ( i > 0 ) && ( url[ i - 1 ] == '/' ) ) ?
+                  http_server_route_parse_parameter( url + i, (uint32_t)( length - i ), &segment_type, &name_length ) : 0;
+            if( end == 0 )
+            {
+                return HTTP_ROUTE_INVALID;
             }
+            parameters = true;
+            ( *segments )++;
+            i += end;
         }
     }
 
-    if( ( cached_string != NULL ) || ( (char*) strnstrn( request_string, request_length, CRLF_CRLF, sizeof(CRLF_CRLF) - 1) == NULL ) )
+    /* Path parameters are captured by the trie only */
+    if( parameters == true )
     {
-      char* new_cached_string;
-      size_t new_cached_length = cached_length + request_length;
+        return ( ( glob == true ) || ( *segments > HTTP_SERVER_MAX_PATH_PARAMETERS ) ) ? HTTP_ROUTE_INVALID : HTTP_ROUTE_TRIE;
+    }
+
+    return ( glob == true ) ? HTTP_ROUTE_GLOB : HTTP_ROUTE_TRIE;
+}
+
+/* Checks that a URL can be registered; a route template must be well formed and fit in the trie */
+static cy_rslt_t http_server_route_check( const cy_http_route_table_t *routes, const char *url )
+{
+    uint32_t segments;
 
-      hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG,"%s() : ----- ### DBG : Caching the request\r\n", __FUNCTION__ );
+    switch( http_server_route_classify( url, strlen( url ), &segments ) )
+    {
+        case HTTP_ROUTE_INVALID:
+            return CY_RSLT_HTTP_SERVER_ERROR_BADARG;
 
-      if( new_cached_length > MAXIMUM_CACHED_LENGTH ) {
-          hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : Request exceeds %d bytes\r\n", __FUNCTION__, MAXIMUM_CACHED_LENGTH );
-          free( cached_string );
-          cached_string = NULL;
-          cached_length = 0;
-          goto exit;
-      }
+        case HTTP_ROUTE_TRIE:
+            /* The glob scan matches '*' across '/' and after every trie route, so a trie route must not fall back to it */
+            if( ( routes->node_count + HTTP_ROUTE_NODES_NEEDED( segments ) ) > routes->max_nodes )
+            {
+                return CY_RSLT_HTTP_SERVER_PAGE_DATABASE_FULL;
+            }
+            return CY_RSLT_SUCCESS;
 
-      new_cached_string = realloc( cached_string, new_cached_length );
+        default:
+            return CY_RSLT_SUCCESS;
+    }
+}
 
-      if( new_cached_string == NULL )
-      {
-          hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : Not enough memory\r\n", __FUNCTION__ );
-          free( cached_string );
-          cached_string = NULL;
-          cached_length = 0;
-          goto exit;
-      }
+/* Returns the segment child of a node for a '*' or '{name}' segment, adding it if there is none yet */
+static uint16_t http_server_route_segment_child( cy_http_route_table_t *routes, uint16_t node, uint8_t segment_type, const char *name, uint16_t name_length )
+{
+    uint16_t* link = &routes->nodes[ node ].segment_child;
+    uint16_t  child;
 
-      memcpy( new_cached_string + cached_length, request_string, request_length );
+    while( *link != HTTP_ROUTE_NONE )
+    {
+        child = *link;
+        if( ( routes->nodes[ child ].segment_type == segment_type ) && ( routes->nodes[ child ].label_length == name_length ) &&
+            ( memcmp( routes->nodes[ child ].label, name, name_length ) == COMPARE_MATCH ) )
+        {
+            return child;
+        }
 
-      cached_string = new_cached_string;
-      cached_length = new_cached_length;
+        /* Typed segments go before untyped ones, so that they are tried first */
+        if( ( segment_type != HTTP_ROUTE_SEGMENT_ANY ) && ( routes->nodes[ child ].segment_type == HTTP_ROUTE_SEGMENT_ANY ) )
+        {
+            break;
+        }
+        link = &routes->nodes[ child ].next_sibling;
+    }
 
-      if( (char*) strnstrn( cached_string, (uint16_t)cached_length, CRLF_CRLF, sizeof(CRLF_CRLF) - 1 ) == NULL )
-      {
-          hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : Not found the end of request\r\n", __FUNCTION__ );
-          goto exit;
-      }
-      else
-      {
-          request_string = cached_string;
-          request_length = (uint16_t)cached_length;
+    child = http_server_route_new_node( routes, name, name_length );
+    routes->nodes[ child ].segment_type = segment_type;
+    routes->nodes[ child ].next_sibling = *link;
+    *link = child;
 
-          cached_string_to_be_freed = cached_string;
+    return child;
+}
 
-          cached_string = NULL;
-          cached_length = 0;
-      }
+/* Follows the literal part of a route in the trie, counting the nodes with wildcards it passes */
+static uint16_t http_server_route_walk_literal( const cy_http_route_table_t *routes, uint16_t node, const char *label, uint32_t length, uint32_t *depth )
+{
+    while( length > 0 )
+    {
+        node    = http_server_route_find_child( routes, node, label[ 0 ] );
+        label  += routes->nodes[ node ].label_length;
+        length -= routes->nodes[ node ].label_length;
+        if( ( routes->nodes[ node ].segment_child != HTTP_ROUTE_NONE ) || ( routes->nodes[ node ].prefix_page != HTTP_ROUTE_NONE ) )
+        {
+            ( *depth )++;
+        }
     }
 
-    /* Verify we have enough data to start processing */
-    if( request_length < MINIMUM_REQUEST_LINE_LENGTH )
+    return node;
+}
+
+/* Follows the segment child of a node for a '*' or '{name}' segment, counting it if it has wildcards */
+static uint16_t http_server_route_walk_segment( const cy_http_route_table_t *routes, uint16_t node, uint8_t segment_type, const char *name, uint16_t name_length, uint32_t *depth )
+{
+    node = routes->nodes[ node ].segment_child;
+    while( ( routes->nodes[ node ].segment_type != segment_type ) || ( routes->nodes[ node ].label_length != name_length ) ||
+           ( memcmp( routes->nodes[ node ].label, name, name_length ) != COMPARE_MATCH ) )
     {
-        result = CY_RSLT_ERROR;
-        goto exit;
+        node = routes->nodes[ node ].next_sibling;
+    }
+    if( ( routes->nodes[ node ].segment_child != HTTP_ROUTE_NONE ) || ( routes->nodes[ node ].prefix_page != HTTP_ROUTE_NONE ) )
+    {
+        ( *depth )++;
     }
 
-    /* First extract the URL from the packet */
-    hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : Extract the request type\r\n", __FUNCTION__ );
-    result = http_server_get_request_type_and_url( request_string, request_length, &http_message_body.request_type, &start_of_url, &url_length );
-    if( result == CY_RSLT_ERROR )
+    return node;
+}
+
+/*
+ * Returns the number of nodes with wildcards on the path of a route of the trie, which a lookup of a URL along that
+ * path may have to remember. Every node is on the path of some route, so no lookup needs more than the largest of them.
+ */
+static uint32_t http_server_route_wildcard_depth( const cy_http_route_table_t *routes, const char *url )
+{
+    size_t    length = strlen( url );
+    uint32_t  start  = 0;
+    uint32_t  depth  = 0;
+    uint32_t  i;
+    uint16_t  node   = HTTP_ROUTE_ROOT;
+    uint16_t  name_length;
+    uint8_t   segment_type;
+
+    if( ( routes->nodes[ node ].segment_child != HTTP_ROUTE_NONE ) || ( routes->nodes[ node ].prefix_page != HTTP_ROUTE_NONE ) )
     {
-        goto exit;
+        depth++;
     }
 
-    hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : request type : %d \r\n", __FUNCTION__, http_message_body.request_type );
+    for( i = 0; i < length; i++ )
+    {
+        if( url[ i ] == '*' )
+        {
+            node = http_server_route_walk_literal( routes, node, url + start, i - start, &depth );
+            if( i + 1 == length )
+            {
+                return depth;
+            }
+            node  = http_server_route_walk_segment( routes, node, HTTP_ROUTE_SEGMENT_ANY, url + i, 0, &depth );
+            start = i + 1;
+        }
+        else if( url[ i ] == '{' )
+        {
+            node  = http_server_route_walk_literal( routes, node, url + start, i - start, &depth );
+            start = i + 1 + http_server_route_parse_parameter( url + i, (uint32_t)( length - i ), &segment_type, &name_length );
+            node  = http_server_route_walk_segment( routes, node, segment_type, url + i + 1, name_length, &depth );
+            i     = start - 1;
+        }
+    }
+    http_server_route_walk_literal( routes, node, url + start, (uint32_t) length - start, &depth );
 
-    /* Remove escape strings from URL */
-    new_url_length = http_server_remove_escaped_characters( start_of_url, url_length, start_of_url, url_length );
+    return depth;
+}
 
-    /* Now extract packet payload info such as data, data length, data type and message length */
-    hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : Extract payload\r\n", __FUNCTION__ );
-    http_message_body.data = (uint8_t*) strnstrn( request_string, request_length, CRLF_CRLF, sizeof( CRLF_CRLF ) - 1 );
+/* Checks that no URL of a route set's trie can need more than HTTP_ROUTE_MAX_WILDCARD_DEPTH wildcards remembered */
+static bool http_server_route_set_depth_fits( const cy_http_route_set_t *set )
+{
+    uint32_t segments;
+    uint16_t i;
 
-    hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : payload\r\n", __FUNCTION__ );
-    int i;
-    for (i = 0; i < request_length; i++)
+    for( i = 0; i < set->resource_count; i++ )
     {
-       hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%02X ", http_message_body.data[i] );
+        if( ( http_server_route_classify( set->pages[ i ].url, strlen( set->pages[ i ].url ), &segments ) == HTTP_ROUTE_TRIE ) &&
+            ( http_server_route_wildcard_depth( &set->routes, set->pages[ i ].url ) > HTTP_ROUTE_MAX_WILDCARD_DEPTH ) )
+        {
+            hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "Route passes more than %d wildcards : [%s]\n", HTTP_ROUTE_MAX_WILDCARD_DEPTH, set->pages[ i ].url );
+            return false;
+        }
     }
-    hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "]\r\n" );
 
-    /* This indicates start of data/end of header was not found, so exit */
-    if( http_message_body.data == NULL )
+    return true;
+}
+
+/* Adds a registered page to the routes; see cy_http_route_table_t. The URL has been checked by http_server_route_check */
+static void http_server_route_add( cy_http_route_table_t *routes, const char *url, uint16_t page )
+{
+    size_t    length   = strlen( url );
+    uint32_t  segments;
+    uint32_t  start    = 0;
+    uint32_t  i;
+    uint16_t  node     = HTTP_ROUTE_ROOT;
+    uint16_t* chain    = NULL;
+    uint16_t  name_length;
+    uint8_t   segment_type;
+
+    routes->next_page[ page ] = HTTP_ROUTE_NONE;
+
+    if( http_server_route_classify( url, length, &segments ) != HTTP_ROUTE_TRIE )
     {
-        result = CY_RSLT_ERROR;
-        goto exit;
+        routes->globs[ routes->glob_count++ ] = page;
+        return;
     }
-    else
-    {
-        /* Payload starts just after the header */
-        http_message_body.data += strlen( CRLF_CRLF );
 
-        /* if there is no payload after header just set data pointer to NULL */
-        if( ( (uint8_t*) ( request_string + request_length ) - http_message_body.data ) == 0 )
+    for( i = 0; ( i < length ) && ( chain == NULL ); i++ )
+    {
+        if( url[ i ] == '*' )
         {
-            http_message_body.data = NULL;
-            http_message_body.data_length = 0;
+            node = http_server_route_insert_literal( routes, node, url + start, i - start );
+            if( i + 1 == length )
+            {
+                chain = &routes->nodes[ node ].prefix_page;
+            }
+            else
+            {
+                node  = http_server_route_segment_child( routes, node, HTTP_ROUTE_SEGMENT_ANY, url + i, 0 );
+                start = i + 1;
+            }
+        }
+        else if( url[ i ] == '{' )
+        {
+            node  = http_server_route_insert_literal( routes, node, url + start, i - start );
+            start = i + 1 + http_server_route_parse_parameter( url + i, (uint32_t)( length - i ), &segment_type, &name_length );
+            node  = http_server_route_segment_child( routes, node, segment_type, url + i + 1, name_length );
+            i     = start - 1;
         }
     }
 
-    hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : Extract content type\r\n", __FUNCTION__ );
-    mime = (char*) strnstrn( request_string, request_length, HTTP_HEADER_CONTENT_TYPE, sizeof( HTTP_HEADER_CONTENT_TYPE ) - 1 );
-    if( ( mime != NULL ) && ( mime < (char*) http_message_body.data ) )
+    if( chain == NULL )
     {
-        mime += strlen( HTTP_HEADER_CONTENT_TYPE );
-        http_message_body.mime_type = http_server_get_mime_type( mime );
+        node  = http_server_route_insert_literal( routes, node, url + start, (uint32_t) length - start );
+        chain = &routes->nodes[ node ].page;
     }
-    else
+
+    while( *chain != HTTP_ROUTE_NONE )
     {
-        http_message_body.mime_type = MIME_TYPE_ALL;
+        chain = &routes->next_page[ *chain ];
     }
+    *chain = page;
+}
 
-    hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : content type : %d \r\n", __FUNCTION__, http_message_body.mime_type );
+/* Sets up an empty route set with room for capacity pages in memory of HTTP_ROUTE_SET_SIZE( capacity ) bytes */
+static cy_http_route_set_t* http_server_route_set_init( uint8_t *memory, uint16_t capacity )
+{
+    cy_http_route_set_t* set = (cy_http_route_set_t*) memory;
+
+    set->next              = NULL;
+    set->successor         = NULL;
+    set->pages             = (cy_http_page_t*) ( memory + sizeof( cy_http_route_set_t ) );
+    set->routes.nodes      = (cy_http_route_node_t*) ( set->pages + capacity );
+    set->routes.next_page  = (uint16_t*) ( set->routes.nodes + HTTP_ROUTE_NODES_FOR( capacity ) );
+    set->routes.globs      = set->routes.next_page + capacity;
+    set->routes.max_nodes  = (uint16_t) HTTP_ROUTE_NODES_FOR( capacity );
+    set->resource_count    = 0;
+    set->capacity          = capacity;
+    set->in_use            = true;
+    http_server_route_table_init( &set->routes );
+
+    return set;
+}
+
+/*
+ * Builds a route set with the pages of the published one, leaving out those registered with removed_url if not NULL.
+ * A server created in application memory has room for two sets of MAX_NUMBER_OF_HTTP_SERVER_RESOURCES pages, and
+ * returns NULL while the one not published is still used by a request.
+ */
+static cy_http_route_set_t* http_server_route_set_copy( cy_http_server_object_t *server_obj, uint16_t capacity, const char *removed_url )
+{
+    const cy_http_route_set_t*     published = server_obj->route_set;
+    cy_http_route_set_t*           set;
+    cy_http_server_static_layout_t layout;
+    uint8_t*                       memory;
+    uint16_t                       i;
 
-    if( strnstrn( request_string, request_length, HTTP_HEADER_CHUNKED, sizeof( HTTP_HEADER_CHUNKED ) - 1 ) )
+    if( server_obj->http_server.static_memory != NULL )
     {
-        /* Indicate the format of this frame is chunked. Its up to the application to parse and reassemble the chunk */
-        http_message_body.is_chunked_transfer = true;
-        if( http_message_body.data != NULL )
+        http_server_get_static_layout( server_obj->max_sockets, &layout );
+        memory = server_obj->http_server.static_memory + layout.route_sets;
+        if( ( (cy_http_route_set_t*) memory == published ) || ( ( (cy_http_route_set_t*) memory )->in_use == true ) )
+        {
+            memory += HTTP_SERVER_STATIC_ALIGN( HTTP_ROUTE_SET_SIZE( MAX_NUMBER_OF_HTTP_SERVER_RESOURCES ) );
+        }
+        if( ( (cy_http_route_set_t*) memory == published ) || ( ( (cy_http_route_set_t*) memory )->in_use == true ) )
         {
-            http_message_body.data_length = (uint16_t) ( (uint8_t*) ( request_string + request_length ) - http_message_body.data );
+            return NULL;
         }
     }
     else
     {
-        message_data_length_string = (char*) strnstrn( request_string, request_length, HTTP_HEADER_CONTENT_LENGTH, sizeof( HTTP_HEADER_CONTENT_LENGTH ) - 1 );
-
-        /* This case handles case where content-length : X but there is no data present in payload, in this case atleast application should be informed about correct
-         * remaining data length so application can take appropriate action
-         */
-        if( ( message_data_length_string != NULL ) && ( http_message_body.data == NULL ) )
+        memory = malloc( HTTP_ROUTE_SET_SIZE( capacity ) );
+        if( memory == NULL )
         {
-            message_data_length_string += ( sizeof( HTTP_HEADER_CONTENT_LENGTH ) - 1 );
-
-            http_message_body.data_remaining = (uint16_t) ( strtol( message_data_length_string, NULL, 10 ) - http_message_body.data_length );
-
-            stream->request.data_remaining = http_message_body.data_remaining;
+            return NULL;
         }
-        else if( ( message_data_length_string != NULL ) && ( message_data_length_string < (char*) http_message_body.data ) )
-        {
-            http_message_body.data_length = (uint16_t) ( (uint8_t*) ( request_string + request_length ) - http_message_body.data );
-
-            message_data_length_string += ( sizeof( HTTP_HEADER_CONTENT_LENGTH ) - 1 );
-
-            http_message_body.data_remaining = (uint16_t) ( strtol( message_data_length_string, NULL, 10 ) - http_message_body.data_length );
+    }
 
-            stream->request.data_remaining = http_message_body.data_remaining;
-        }
-        else
+    set = http_server_route_set_init( memory, capacity );
+    for( i = 0; ( published != NULL ) && ( i < published->resource_count ); i++ )
+    {
+        if( ( removed_url == NULL ) || ( strcmp( published->pages[ i ].url, removed_url ) != COMPARE_MATCH ) )
         {
-            http_message_body.data_length = 0;
-            stream->request.data_remaining = 0;
+            set->pages[ set->resource_count ] = published->pages[ i ];
+            http_server_route_add( &set->routes, set->pages[ set->resource_count ].url, set->resource_count );
+            set->resource_count++;
         }
-        stream->request.mime_type = http_message_body.mime_type;
-        stream->request.request_type = http_message_body.request_type;
     }
 
-    hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : Process the URL request\r\n", __FUNCTION__ );
-    result = http_server_process_url_request( stream, server->page_database, start_of_url, new_url_length, &http_message_body );
-
-exit:
-    free(cached_string_to_be_freed);
+    return set;
+}
 
-    if( disconnect_current_connection == true )
+/* Doubles the capacity of the next route set; the route set of a server created in application memory cannot grow */
+static bool http_server_route_set_grow( const cy_http_server_object_t *server_obj, uint16_t *capacity )
+{
+    if( ( server_obj->http_server.static_memory != NULL ) || ( *capacity >= HTTP_ROUTE_MAX_CAPACITY ) )
     {
-        cy_http_server_response_stream_disconnect( &stream->response );
+        return false;
     }
 
-    return result;
+    *capacity = ( *capacity > ( HTTP_ROUTE_MAX_CAPACITY / 2 ) ) ? (uint16_t) HTTP_ROUTE_MAX_CAPACITY : (uint16_t)( *capacity * 2 );
+    return true;
 }
 
-cy_rslt_t http_server_process_url_request( cy_http_stream_t *stream, const cy_http_page_t *page_database, char *url, uint32_t url_length, cy_http_message_body_t *http_message_body )
+/*
+ * Publishes a route set built by http_server_route_set_copy in place of the published one. While the server runs, the
+ * replaced set is then passed to the event thread, which frees it once no request uses it. If the event queue is full,
+ * the set waits on a list that the event thread takes after the sets posted before it, so they are freed in order.
+ */
+static void http_server_route_set_publish( cy_http_server_object_t *server_obj, cy_http_route_set_t *set )
 {
-    char                     *url_query_parameters = url;
-    uint32_t                 query_length = url_length;
-    cy_http_page_t           *page_found = NULL;
-    cy_http_mime_type_t      mime_type = MIME_TYPE_ALL;
-    cy_http_status_codes_t   status_code;
-    cy_rslt_t                result = CY_RSLT_SUCCESS;
+    cy_http_server_info_t* server   = &server_obj->http_server;
+    cy_http_route_set_t*   replaced = server_obj->route_set;
+    cy_http_route_set_t**  link;
+    server_event_message_t message;
 
-    url[ url_length ] = '\x00';
+    HTTP_ROUTE_PUBLISH_BARRIER();
+    server_obj->route_set = set;
 
-    while( ( *url_query_parameters != '?' ) && ( query_length > 0 ) && ( *url_query_parameters != '\0' ) )
+    if( replaced == NULL )
     {
-        url_query_parameters++;
-        query_length--;
+        return;
     }
 
-    if( query_length != 0 )
-    {
-        url_length = url_length - query_length;
-        *url_query_parameters = '\x00';
-        url_query_parameters++;
-    }
-    else
+    /* No request can be using the replaced set while the server is stopped */
+    if( server_obj->is_started == false )
     {
-        url_query_parameters = NULL;
+        http_server_route_set_release( server, replaced, set );
+        return;
     }
 
-    /* Find URL in server page database */
-    if( http_server_find_url_in_page_database( url, url_length, http_message_body, page_database, &page_found, &mime_type ) == CY_RSLT_SUCCESS )
-    {
-        stream->request.page_found = page_found;
-        status_code = CY_HTTP_200_TYPE; /* OK */
-    }
-    else
-    {
-        stream->request.page_found = NULL;
-        status_code = CY_HTTP_404_TYPE; /* Not Found */
-    }
+    replaced->successor = set;
+    replaced->next      = NULL;
 
-    if( status_code == CY_HTTP_200_TYPE )
+    cy_rtos_get_mutex( &server->mutex, CY_RTOS_NEVER_TIMEOUT );
+    if( server->unposted_route_sets == NULL )
     {
-        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : URL content type = [%d]\r\n", __FUNCTION__, page_found->url_content_type );
-        /* Call the content handler function to write the page content into the packet and adjust the write pointers */
-        switch ( page_found->url_content_type )
+        message.event_type = CY_SERVER_ROUTES_EVENT;
+        message.socket     = replaced;
+        if( cy_rtos_put_queue( &event_queue, &message, 0, 0 ) == CY_RSLT_SUCCESS )
         {
-            case CY_DYNAMIC_URL_CONTENT:
-                hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : CY_DYNAMIC_URL_CONTENT\r\n", __FUNCTION__ );
-                cy_http_server_response_stream_enable_chunked_transfer( &stream->response );
-                cy_http_server_response_stream_write_header( &stream->response, status_code, CHUNKED_CONTENT_LENGTH, CY_HTTP_CACHE_DISABLED, mime_type );
-                result = page_found->url_content.dynamic_data.generator( url, url_query_parameters, &stream->response, page_found->url_content.dynamic_data.arg, http_message_body );
-                /* if content length is < MTU then just disable chunked transfer and flush the data */
-                if( stream->request.data_remaining == 0 )
-                {
-                    cy_http_server_response_stream_disable_chunked_transfer( &stream->response );
-                    CY_VERIFY( cy_http_server_response_stream_flush( &stream->response ) );
-                }
-                break;
-
-            case CY_RAW_DYNAMIC_URL_CONTENT:
-                hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : CY_RAW_DYNAMIC_URL_CONTENT\r\n", __FUNCTION__ );
-                result = page_found->url_content.dynamic_data.generator( url, url_query_parameters, &stream->response, page_found->url_content.dynamic_data.arg, http_message_body );
-                /* if content length is < MTU then just flush the response */
-                if( stream->request.data_remaining == 0 )
-                {
-                    CY_VERIFY( cy_http_server_response_stream_flush( &stream->response ) );
-                }
-                break;
-
-            case CY_STATIC_URL_CONTENT:
-                hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : CY_STATIC_URL_CONTENT\r\n", __FUNCTION__ );
-                cy_http_server_response_stream_write_header( &stream->response, status_code, page_found->url_content.static_data.length, CY_HTTP_CACHE_ENABLED, mime_type );
-                CY_VERIFY( cy_http_server_response_stream_write_payload( &stream->response, page_found->url_content.static_data.ptr, page_found->url_content.static_data.length ) );
-                CY_VERIFY( cy_http_server_response_stream_flush( &stream->response ) );
-                break;
-
-            case CY_RAW_STATIC_URL_CONTENT: /* This is just a Location header */
-                hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : CY_RAW_STATIC_URL_CONTENT\n", __FUNCTION__ );
-                CY_VERIFY( cy_http_server_response_stream_write_payload( &stream->response, page_found->url_content.static_data.ptr, page_found->url_content.static_data.length ) );
-                CY_VERIFY( cy_http_server_response_stream_flush( &stream->response ) );
-                break;
-
-            case CY_RESOURCE_URL_CONTENT:
-                hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : CY_RESOURCE_URL_CONTENT\r\n", __FUNCTION__ );
-                /* Fall through */
-            case CY_RAW_RESOURCE_URL_CONTENT:
-                hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : CY_RAW_RESOURCE_URL_CONTENT\r\n", __FUNCTION__ );
-                cy_http_server_response_stream_enable_chunked_transfer( &stream->response );
-                cy_http_server_response_stream_write_header( &stream->response, status_code, CHUNKED_CONTENT_LENGTH, CY_HTTP_CACHE_DISABLED, mime_type );
-                cy_http_server_response_stream_write_resource( &stream->response, page_found->url_content.resource_data );
-                cy_http_server_response_stream_disable_chunked_transfer( &stream->response );
-                CY_VERIFY( cy_http_server_response_stream_flush( &stream->response ) );
-                break;
-
-            default:
-                hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### DBG : default\r\n", __FUNCTION__ );
-                break;
+            server->posted_route_sets++;
+            cy_rtos_set_mutex( &server->mutex );
+            return;
         }
     }
-    else if( status_code >= CY_HTTP_400_TYPE )
+
+    link = (cy_http_route_set_t**) &server->unposted_route_sets;
+    while( *link != NULL )
     {
-        cy_http_server_response_stream_write_header( &stream->response, status_code, NO_CONTENT_LENGTH, CY_HTTP_CACHE_DISABLED, MIME_TYPE_TEXT_HTML );
-        CY_VERIFY( cy_http_server_response_stream_flush( &stream->response ) );
+        link = &( *link )->next;
     }
-
-    return result;
+    *link = replaced;
+    cy_rtos_set_mutex( &server->mutex );
 }
 
-uint16_t http_server_remove_escaped_characters( char *output, uint16_t output_length, const char *input, uint16_t input_length )
+/*
+ * Frees a route set that no request uses. The responses built for its pages are shared with the set that replaced
+ * it, which keeps the pages it has in the same order, and are freed with the last set having them.
+ */
+static void http_server_route_set_release( cy_http_server_info_t *server, cy_http_route_set_t *set, const cy_http_route_set_t *successor )
 {
-    uint16_t bytes_copied;
-    int a;
+    cy_http_page_t* page;
+    uint16_t        i;
+    uint16_t        kept = 0;
 
-    for ( bytes_copied = 0; ( input_length > 0 ) && ( bytes_copied != output_length ); ++bytes_copied )
+    if( server->static_memory != NULL )
     {
-        if( *input == '%' )
-        {
-            --input_length;
-            /* If there is only % remain in encoded URL string, then just return as it is not valid */
-            if( input_length == 0 )
-            {
-                return 0;
-            }
-
-            ++input;
+        HTTP_ROUTE_PUBLISH_BARRIER();
+        set->in_use = false;
+        return;
+    }
 
-            /* Valid encoding should result as % followed by two hexadecimal digits. If encoded URL comes with %% then just return as it is invalid */
-            if( *input == '%' )
-            {
-                return 0;
-            }
-            else
+    for( i = 0; i < set->resource_count; i++ )
+    {
+        page = &set->pages[ i ];
+        if( ( successor != NULL ) && ( kept < successor->resource_count ) && ( successor->pages[ kept ].url == page->url ) &&
+            ( successor->pages[ kept ].mime_type == page->mime_type ) )
+        {
+            /* The methods of a kept page may have been set again */
+            if( successor->pages[ kept ].method_response != page->method_response )
             {
-                *output = 0;
-
-                /* As per RFC 3986 : percent encoding octet is encoded as character triplet, consisting of "%" followed by two hexadecimal digits. After percentage if we are not able to
-                 * find two hexadecimal digits then return as it is invalid encoded URL */
-                if(input_length < 2)
-                {
-                    return 0;
-                }
-
-                for ( a = 0; (a < 2); ++a )
-                {
-                    *output = (char) ( *output << 4 );
-                    if( *input >= '0' && *input <= '9' )
-                    {
-                        *output = (char) ( *output + *input - '0' );
-                    }
-                    else if( *input >= 'a' && *input <= 'f' )
-                    {
-                        *output = (char) ( *output + *input - 'a' + 10 );
-                    }
-                    else if( *input >= 'A' && *input <= 'F' )
-                    {
-                        *output = (char) ( *output + *input - 'A' + 10 );
-                    }
-                    else
-                    {
-                        return 0;
-                    }
-                    --input_length;
-                    if( input_length > 0 )
-                    {
-                        ++input;
-                    }
-                }
-                ++output;
+                free( page->method_response );
             }
+            kept++;
+            continue;
         }
-        else
+        if( page->url_content_type == CY_STATIC_URL_CONTENT )
         {
-            /* If there is + present in encoded URL then replace with space */
-            if( *input == '+' )
-            {
-                *output = ' ';
-            }
-            else
-            {
-                *output = *input;
-            }
-
-            --input_length;
-            if( input_length > 0 )
-            {
-                ++input;
-                ++output;
-            }
+            free( page->url_content.static_data.header );
         }
+        free( page->method_response );
     }
 
-    return bytes_copied;
+    free( set );
 }
 
-cy_http_mime_type_t http_server_get_mime_type( const char *request_data )
+/* Frees the route sets of a server that is stopped or deleted, leaving it with no resources */
+static void http_server_release_route_sets( cy_http_server_object_t *server_obj )
 {
-    cy_http_mime_type_t mime_type = MIME_TYPE_TLV;
+    cy_http_route_set_t* set;
 
-    if( request_data != NULL )
+    /* Sets not yet taken by the event thread were replaced after the ones it took */
+    http_server_retire_route_sets( &server_obj->http_server, server_obj->http_server.unposted_route_sets );
+    server_obj->http_server.unposted_route_sets = NULL;
+    server_obj->http_server.posted_route_sets   = 0;
+    server_obj->http_server.taken_route_sets    = 0;
+
+    while( ( set = server_obj->http_server.retired_route_sets ) != NULL )
     {
-        while( mime_type < MIME_TYPE_ALL )
-        {
-            if( strncmp( request_data, http_mime_array[ mime_type ], strlen( http_mime_array[ mime_type ] ) ) == COMPARE_MATCH )
-            {
-                break;
-            }
-            mime_type++;
-        }
+        server_obj->http_server.retired_route_sets = set->next;
+        http_server_route_set_release( &server_obj->http_server, set, set->successor );
     }
-    else
+
+    if( server_obj->route_set != NULL )
     {
-        /* If MIME not specified, assumed all supported (according to rfc2616)*/
-        mime_type = MIME_TYPE_ALL;
+        set = server_obj->route_set;
+        server_obj->route_set = NULL;
+        http_server_route_set_release( &server_obj->http_server, set, NULL );
     }
-    return mime_type;
 }
 
-cy_rslt_t http_server_get_request_type_and_url( char *request, uint16_t request_length, cy_http_request_type_t *type, char **url_start, uint16_t *url_length )
+/* Appends route sets replaced by the application, which are no longer published, to the retired ones */
+static void http_server_retire_route_sets( cy_http_server_info_t *server, cy_http_route_set_t *sets )
 {
-    char* end_of_url;
+    cy_http_route_set_t** link = &server->retired_route_sets;
 
-    end_of_url = (char*) strnstrn( request, request_length, HTTP_1_1_TOKEN, sizeof( HTTP_1_1_TOKEN ) - 1 );
-    if( end_of_url == NULL )
+    while( *link != NULL )
     {
-        return CY_RSLT_ERROR;
+        link = &( *link )->next;
     }
+    *link = sets;
+}
 
-    if( memcmp( request, GET_TOKEN, sizeof( GET_TOKEN ) - 1 ) == COMPARE_MATCH )
-    {
-        /* Get type  */
-        *type = CY_HTTP_REQUEST_GET;
-        *url_start = request + sizeof( GET_TOKEN ) - 1;
-        *url_length = (uint16_t) ( end_of_url - *url_start );
-    }
-    else if( memcmp( request, POST_TOKEN, sizeof( POST_TOKEN ) - 1 ) == COMPARE_MATCH )
-    {
-        *type = CY_HTTP_REQUEST_POST;
-        *url_start = request + sizeof( POST_TOKEN ) - 1;
-        *url_length = (uint16_t) ( end_of_url - *url_start );
-    }
-    else if( memcmp( request, PUT_TOKEN, sizeof( PUT_TOKEN ) - 1 ) == COMPARE_MATCH )
+/*
+ * Takes the route sets replaced while the event queue was full, once all the sets posted before them are taken;
+ * called by the event thread, which tries again after its next event rather than wait for the application.
+ */
+static void http_server_take_unposted_route_sets( cy_http_server_info_t *server )
+{
+    if( cy_rtos_get_mutex( &server->mutex, 0 ) != CY_RSLT_SUCCESS )
     {
-        *type = CY_HTTP_REQUEST_PUT;
-        *url_start = request + sizeof( PUT_TOKEN ) - 1;
-        *url_length = (uint16_t) ( end_of_url - *url_start );
+        return;
     }
-    else
+
+    if( server->taken_route_sets == server->posted_route_sets )
     {
-        *type = CY_HTTP_REQUEST_UNDEFINED;
-        return CY_RSLT_ERROR;
+        http_server_retire_route_sets( server, server->unposted_route_sets );
+        server->unposted_route_sets = NULL;
     }
-
-    return CY_RSLT_SUCCESS;
+    cy_rtos_set_mutex( &server->mutex );
 }
 
-cy_rslt_t http_server_find_url_in_page_database( char *url, uint32_t length, cy_http_message_body_t *http_request, const cy_http_page_t *page_database, cy_http_page_t **page_found, cy_http_mime_type_t *mime_type )
+/* Frees the retired route sets, oldest first, that no request uses any more; called by the event thread between events */
+static void http_server_reclaim_route_sets( cy_http_server_info_t *server )
 {
-    uint32_t i = 0;
-
-    /* Search URL list to determine if request matches one of our pages, and break out when found */
-    if( page_database == NULL )
-    {
-        return CY_RSLT_ERROR;
-    }
+    cy_http_route_set_t* set;
+    cy_stream_node_t*    stream;
 
-    while( (i < MAX_NUMBER_OF_HTTP_SERVER_RESOURCES) && (page_database[ i ].url != NULL) )
+    while( ( set = server->retired_route_sets ) != NULL )
     {
-        if( match_string_with_wildcard_pattern( url, length, page_database[ i ].url ) != 0 )
+        if( cy_linked_list_find_node( &server->active_stream_list, http_server_compare_stream_route_set, set, (cy_linked_list_node_t**) &stream ) == CY_RSLT_SUCCESS )
         {
-            *mime_type = http_server_get_mime_type( page_database[ i ].mime_type );
-
-            if( ( *mime_type == http_request->mime_type ) || ( http_request->mime_type == MIME_TYPE_ALL ) )
-            {
-                *page_found = (cy_http_page_t*)&page_database[i];
-                return CY_RSLT_SUCCESS;
-            }
+            break;
         }
-        i++;
-    }
 
-    return CY_RSLT_HTTP_SERVER_ERROR_NOT_FOUND;
+        server->retired_route_sets = set->next;
+        http_server_route_set_release( server, set, set->successor );
+    }
 }
 
 void http_server_connect_thread_main( cy_thread_arg_t arg )
@@ -2189,6 +6137,8 @@ void http_server_event_thread_main( cy_thread_arg_t arg )
     cy_stream_node_t*      stream = NULL;
     server_event_message_t current_event;
     char buffer[HTTP_SERVER_MTU_SIZE];
+    char*            receive_buffer;
+    uint32_t         receive_size;
     cy_rslt_t        status;
     int received_length = 0;
     cy_tcp_socket_t* client_socket;
@@ -2230,6 +6180,7 @@ void http_server_event_thread_main( cy_thread_arg_t arg )
                         cy_rtos_get_mutex( &http_server->mutex, CY_RTOS_NEVER_TIMEOUT );
                         cy_linked_list_remove_node( &http_server->active_stream_list, &stream->node );
                         cy_linked_list_insert_node_at_rear( &http_server->inactive_stream_list, &stream->node );
+                        http_server_release_reassembly_buffer( http_server, &stream->stream );
                         cy_rtos_set_mutex( &http_server->mutex );
                         http_response_stream_deinit( &stream->stream.response );
                         cy_tcp_server_disconnect_socket( &http_server->tcp_server, tcp_socket );
@@ -2258,6 +6209,7 @@ void http_server_event_thread_main( cy_thread_arg_t arg )
                 hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "### DBG : Stop event processed\r\n" );
                 break;
             }
+            case CY_SERVER_RESUME_EVENT:
             case CY_SOCKET_PACKET_RECEIVED_EVENT:
             {
                 client_socket = current_event.socket;
@@ -2267,13 +6219,36 @@ void http_server_event_thread_main( cy_thread_arg_t arg )
                     /* Stream is not available, it means that client already disconnected to server but these are stale events */
                     break;
                 }
+
+                if( current_event.event_type == CY_SERVER_RESUME_EVENT )
+                {
+                    /* Receive events that arrived while paused were dropped, so read until the socket is empty */
+                    stream->stream.request.receive_paused = false;
+                    stream->stream.request.receive_drain  = true;
+                    current_event.event_type = CY_SOCKET_PACKET_RECEIVED_EVENT;
+                }
+
+                if( stream->stream.request.receive_paused == true )
+                {
+                    /* Leave the data in the socket so the TCP receive window closes on the client; resuming reads it */
+                    hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "L%d : %s() : ----- Receive paused by the URL handler \r\n", __LINE__, __FUNCTION__ );
+                    break;
+                }
                 else
                 {
-                    received_length = cy_tcp_server_recv( client_socket, buffer, HTTP_SERVER_MTU_SIZE );
+                    /* The packet is parsed in place in the buffer it is received in */
+                    receive_buffer = http_server_get_receive_buffer( http_server, &stream->stream, buffer, &receive_size );
+                    received_length = cy_tcp_server_recv( client_socket, receive_buffer, (int) receive_size );
                     hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "Received [%d] bytes \r\n", received_length );
+                    if( received_length <= 0 )
+                    {
+                        http_server_put_receive_buffer( http_server, &stream->stream );
+                    }
+
                     if( received_length == CY_HTTP_SERVER_SOCKET_NO_DATA )
                     {
                         hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "L%d : %s() : ----- No data is available to read \r\n", __LINE__, __FUNCTION__ );
+                        stream->stream.request.receive_drain = false;
                         break;
                     }
 
@@ -2297,6 +6272,7 @@ void http_server_event_thread_main( cy_thread_arg_t arg )
                             cy_rtos_get_mutex( &http_server->mutex, CY_RTOS_NEVER_TIMEOUT );
                             cy_linked_list_remove_node( &http_server->active_stream_list, &stream->node );
                             cy_linked_list_insert_node_at_rear( &http_server->inactive_stream_list, &stream->node );
+                            http_server_release_reassembly_buffer( http_server, &stream->stream );
                             cy_rtos_set_mutex( &http_server->mutex );
                             http_response_stream_deinit( &stream->stream.response );
                         }
@@ -2332,6 +6308,7 @@ void http_server_event_thread_main( cy_thread_arg_t arg )
                                         http_server->inactive_stream_list.count );
                                 cy_linked_list_remove_node( &http_server->active_stream_list, &stream->node );
                                 cy_linked_list_insert_node_at_rear( &http_server->inactive_stream_list, &stream->node );
+                                http_server_release_reassembly_buffer( http_server, &stream->stream );
 
                                 cy_rtos_set_mutex( &http_server->mutex );
                             }
@@ -2343,10 +6320,26 @@ void http_server_event_thread_main( cy_thread_arg_t arg )
                     else
                     {
                         /* Process packet */
-                        if( received_length <= HTTP_SERVER_MTU_SIZE )
+                        if( received_length <= (int) receive_size )
                         {
                             hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "L%d : %s() : Parse the HTTP packet\r\n", __LINE__, __FUNCTION__ );
-                            http_server_parse_receive_packet( http_server, &stream->stream, buffer, received_length );
+
+                            /* A full read may have left data in the socket, and the stack does not signal it again; read
+                             * until no data is left, the same way as after receive is resumed.
+                             */
+                            if( received_length == (int) receive_size )
+                            {
+                                stream->stream.request.receive_drain = true;
+                            }
+
+                            http_server_parse_receive_packet( http_server, &stream->stream, receive_buffer, received_length );
+                            http_server_put_receive_buffer( http_server, &stream->stream );
+
+                            /* Keep reading what was left in the socket while receive was paused, unless paused again */
+                            if( ( stream->stream.request.receive_drain == true ) && ( stream->stream.request.receive_paused == false ) )
+                            {
+                                cy_rtos_put_queue( &event_queue, &current_event, 0, 0 );
+                            }
                         }
                         else
                         {
@@ -2357,12 +6350,30 @@ void http_server_event_thread_main( cy_thread_arg_t arg )
                 break;
             }
 
+            case CY_SERVER_ROUTES_EVENT:
+            {
+                /* Routes replaced by the application; freed below once no request uses them */
+                http_server_retire_route_sets( http_server, (cy_http_route_set_t*) current_event.socket );
+                http_server->taken_route_sets++;
+                break;
+            }
+
             default:
             {
                 hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "L%d : %s() : Unhandled event type [%d]\r\n", __LINE__, __FUNCTION__, current_event.event_type );
                 break;
             }
         }
+
+        if( http_server->unposted_route_sets != NULL )
+        {
+            http_server_take_unposted_route_sets( http_server );
+        }
+
+        if( http_server->retired_route_sets != NULL )
+        {
+            http_server_reclaim_route_sets( http_server );
+        }
     }
 
     hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "%s() : ----- ### Exited from event thread \r\n", __FUNCTION__ );
@@ -2370,6 +6381,17 @@ void http_server_event_thread_main( cy_thread_arg_t arg )
     cy_rtos_exit_thread();
 }
 
+/* Matches a stream still receiving the body of a request for a page of the route set in user_data */
+static bool http_server_compare_stream_route_set( cy_linked_list_node_t *node_to_compare, void *user_data )
+{
+    const cy_http_route_set_t* set    = (const cy_http_route_set_t*) user_data;
+    cy_stream_node_t*          stream = (cy_stream_node_t*) node_to_compare;
+    uintptr_t                  page   = (uintptr_t) stream->stream.request.page_found;
+
+    return ( page >= (uintptr_t) set->pages ) && ( page < (uintptr_t) ( set->pages + set->resource_count ) ) &&
+           ( http_server_request_body_pending( &stream->stream ) == true );
+}
+
 bool http_server_compare_stream_socket( cy_linked_list_node_t *node_to_compare, void *user_data )
 {
     cy_tcp_socket_t*  socket = (cy_tcp_socket_t*) user_data;
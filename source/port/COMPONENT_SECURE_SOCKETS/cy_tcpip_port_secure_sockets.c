@@ -190,6 +190,7 @@ cy_rslt_t cy_tcp_server_start( cy_tcp_server_t* server,
     cy_network_interface_t *interface;
     cy_socket_sockaddr_t *tcp_server_addr;
     bool socketcreated = false;
+    uint16_t index;
     cy_socket_tls_auth_mode_t mode = CY_SOCKET_TLS_VERIFY_NONE;
 
     if( server == NULL || network_interface == NULL )
@@ -214,6 +215,27 @@ cy_rslt_t cy_tcp_server_start( cy_tcp_server_t* server,
     /* Intialize tcp server socket list */
     cy_linked_list_init( &server->socket_list );
 
+    /* Client sockets are allocated once, so that accepting and closing a connection does not use the heap. The caller
+     * may provide the memory for them instead.
+     */
+    cy_linked_list_init( &server->free_socket_list );
+    server->free_client_sockets = ( server->client_sockets == NULL );
+    if( server->free_client_sockets == true )
+    {
+        server->client_sockets = ( cy_tcp_socket_t* ) malloc( sizeof(cy_tcp_socket_t) * max_sockets );
+    }
+    if( server->client_sockets == NULL )
+    {
+        hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nFailed to allocate memory for client sockets in cy_tcp_server_start" );
+        result = CY_RSLT_TCPIP_ERROR_NO_MEMORY;
+        goto exit;
+    }
+
+    for( index = 0; index < max_sockets; index++ )
+    {
+        cy_linked_list_insert_node_at_rear( &server->free_socket_list, &server->client_sockets[index].socket_node );
+    }
+
     if( type == CY_HTTP_SERVER_TYPE_SECURE )
     {
         result = cy_socket_create( CY_SOCKET_DOMAIN_AF_INET, CY_SOCKET_TYPE_STREAM,
@@ -313,6 +335,12 @@ cy_rslt_t cy_tcp_server_start( cy_tcp_server_t* server,
 exit :
     cy_rtos_deinit_mutex( &server->mutex );
     cy_linked_list_deinit( &server->socket_list );
+    cy_linked_list_deinit( &server->free_socket_list );
+    if( server->free_client_sockets == true )
+    {
+        free( server->client_sockets );
+    }
+    server->client_sockets = NULL;
     if( socketcreated == true )
     {
         cy_socket_delete( server->server_socket.socket );
@@ -345,13 +373,15 @@ cy_rslt_t cy_tcp_server_accept( cy_tcp_server_t* server,
     else
     {
 
-        /* Allocate memory to accept client socket */
-        *accepted_socket = ( cy_tcp_socket_t* ) malloc( sizeof(cy_tcp_socket_t) );
-        if( *accepted_socket == NULL )
+        /* Take a client socket from those allocated at start */
+        cy_rtos_get_mutex( &server->mutex, CY_RTOS_NEVER_TIMEOUT );
+        if( cy_linked_list_remove_node_from_front( &server->free_socket_list, (cy_linked_list_node_t**) accepted_socket ) != CY_RSLT_SUCCESS )
         {
-            hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nFailed to allocate memory for new client in cy_tcp_server_accept" );
-            return CY_RSLT_TCPIP_ERROR_NO_MEMORY;
+            cy_rtos_set_mutex( &server->mutex );
+            hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_ERR, "\nNo free client socket in cy_tcp_server_accept" );
+            return CY_RSLT_TCPIP_ERROR_NO_MORE_SOCKET;
         }
+        cy_rtos_set_mutex( &server->mutex );
 
         client_socket = *accepted_socket;
 
@@ -362,7 +392,9 @@ cy_rslt_t cy_tcp_server_accept( cy_tcp_server_t* server,
         if( result != CY_RSLT_SUCCESS )
         {
             hs_cy_log_msg( CYLF_MIDDLEWARE, CY_LOG_DEBUG, "\nFailed to accept incoming client connection. Error: [0x%X]\n", ( unsigned int )result );
-            free( *accepted_socket );
+            cy_rtos_get_mutex( &server->mutex, CY_RTOS_NEVER_TIMEOUT );
+            cy_linked_list_insert_node_at_rear( &server->free_socket_list, &client_socket->socket_node );
+            cy_rtos_set_mutex( &server->mutex );
             *accepted_socket = NULL;
             return result;
         }
@@ -675,6 +707,12 @@ cy_rslt_t cy_tcp_server_stop( cy_tcp_server_t* server )
 
     server->server_socket.socket = NULL;
     cy_linked_list_deinit( &server->socket_list );
+    cy_linked_list_deinit( &server->free_socket_list );
+    if( server->free_client_sockets == true )
+    {
+        free( server->client_sockets );
+    }
+    server->client_sockets = NULL;
     cy_rtos_deinit_mutex( &server->mutex );
 
     return result;
@@ -733,7 +771,7 @@ cy_rslt_t cy_tcp_server_disconnect_socket( cy_tcp_server_t* server, cy_tcp_socke
              * In case of unexpected network disconnection, cy_socket_disconnect API always returns failure.
              * Return value of cy_socket_disconnect API is not checked here to avoid calling multiple times the API.
              */
-            free( client_socket );
+            cy_linked_list_insert_node_at_rear( &server->free_socket_list, &client_socket->socket_node );
             current_client_node = NULL;
 
             server->active_tcp_connections = server->active_tcp_connections - 1;
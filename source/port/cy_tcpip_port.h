@@ -87,6 +87,9 @@ typedef struct
     cy_server_type_t      type;
     cy_tcp_socket_t       server_socket;
     cy_linked_list_t      socket_list;
+    cy_tcp_socket_t       *client_sockets;        /* Client sockets for max_tcp_connections, allocated when the server starts */
+    cy_linked_list_t      free_socket_list;       /* Client sockets not in use */
+    bool                  free_client_sockets;    /* client_sockets was allocated by cy_tcp_server_start rather than provided */
     cy_tls_identity_t     *identity;
     uint8_t               *root_ca_certificate;
     uint8_t               root_ca_certificate_length;